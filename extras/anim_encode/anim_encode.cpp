@@ -0,0 +1,202 @@
+/* file: anim_encode.cpp
+*--------------------------------------------------------------------------
+*
+* host (PC) tool. Makes an OLED_Anim PROGMEM array from raw frame files.
+*
+* Each frame file is the display RAM image: pages 0 to 7 (or 0 to 3), 128
+* bytes per page, each byte one pixel column with bit 0 at top.
+*
+* build:  g++ -O2 -o anim_encode anim_encode.cpp
+* usage:  anim_encode name height frame0.bin frame1.bin ... > name.h
+*
+* The C array goes to stdout. The bus clocks of each frame, and the highest
+* frame rate the worst frame allows at 100kHz and 400kHz, go to stderr.
+* These are bus limits. AVR time between bytes lowers them a little.
+*
+* After the last frame comes ANIM_LOOP and the wrap frame, the change from
+* the last frame back to frame 0, so a looping animation never clears.
+*
+*  © Dave Harris, 2021 (Andover, UK) MERG M2740
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+
+static const int COLS      = 128;
+static const int MERGE_GAP = 8;     /* join spans closer than a new window  */
+
+static const int FRAME_END = 0xFF;  /* as oled_Anim.h                       */
+static const int ANIM_END  = 0xFE;
+static const int ANIM_LOOP = 0xFD;
+
+static const int WINDOW_BYTES = 4 * 2;  /* Co ctrl & 0xB0+p, 0x21, c0, c1   */
+static const int DATA_BYTES   = 2;      /* adr, data ctrl                   */
+static const int TXNS         = 1;      /* window merged with data          */
+
+
+
+/*------------------------------- loadFrame() --------------------------------
+ *
+ * read one raw frame file, pages * 128 bytes
+*/
+
+static bool loadFrame( const char * fileName, std::vector<uint8_t> & frame )
+{
+  FILE * f = fopen( fileName, "rb" );
+
+  if( ! f )
+  {
+    return false;
+  }
+  size_t got = fread( frame.data(), 1, frame.size(), f );
+
+  fclose( f );
+
+  return got == frame.size();
+}
+
+
+
+/*------------------------------- encodeFrame() ------------------------------
+ *
+ * append the spans that change prev into next. Returns bus clocks of frame,
+ * 9 per byte plus ~2 per transaction for start & stop.
+*/
+
+static long encodeFrame( const std::vector<uint8_t> & prev,
+                         const std::vector<uint8_t> & next,
+                         int pages, std::vector<uint8_t> & out )
+{
+  long busClocks = 0;
+
+  for( int page = 0; page < pages; page++ )
+  {
+    const uint8_t * p = & prev[ page * COLS ];
+    const uint8_t * n = & next[ page * COLS ];
+
+    int col = 0;
+
+    while( col < COLS )
+    {
+      if( p[col] == n[col] )
+      {
+        col++;
+        continue;
+      }
+      int first = col;
+      int last  = col;
+      int same  = 0;
+
+      for( col++; col < COLS && same <= MERGE_GAP; col++ )
+      {
+        if( p[col] != n[col] )
+        {
+          last = col;
+          same = 0;
+        }
+        else
+        {
+          same++;
+        }
+      }
+      col = last + 1;
+
+      int siz = last - first + 1;
+
+      out.push_back( page );
+      out.push_back( first );
+      out.push_back( siz );
+      out.insert( out.end(), n + first, n + last + 1 );
+
+      busClocks += ( WINDOW_BYTES + DATA_BYTES + siz ) * 9 + TXNS * 2;
+    }
+  }
+  out.push_back( FRAME_END );
+
+  return busClocks;
+}
+
+
+
+int main( int argc, char * argv[] )
+{
+  if( argc < 4 )
+  {
+    fprintf( stderr, "usage: anim_encode name height frame0.bin ...\n" );
+    return 1;
+  }
+  const char * name  = argv[1];
+  int          pages = atoi( argv[2] ) / 8;
+
+  if( pages != 4 && pages != 8 )
+  {
+    fprintf( stderr, "height must be 32 or 64\n" );
+    return 1;
+  }
+
+  std::vector<uint8_t> prev( pages * COLS, 0 );  /* start from clear screen */
+  std::vector<uint8_t> next( pages * COLS );
+  std::vector<uint8_t> first;
+  std::vector<uint8_t> out;
+
+  long worst = 0;
+  long total = 0;
+  int  count = argc - 3;
+
+  for( int i = 0; i < count; i++ )
+  {
+    if( ! loadFrame( argv[ 3 + i ], next ) )
+    {
+      fprintf( stderr, "can not read %s\n", argv[ 3 + i ] );
+      return 1;
+    }
+    long busClocks = encodeFrame( prev, next, pages, out );
+
+    fprintf( stderr, "frame %3d: %6ld bus clocks\n", i, busClocks );
+
+    total += busClocks;
+    if( busClocks > worst && i > 0 )      /* frame 0 is sent once at start */
+    {
+      worst = busClocks;
+    }
+    if( i == 0 )
+    {
+      first = next;
+    }
+    prev = next;
+  }
+
+  out.push_back( ANIM_LOOP );             /* wrap frame, last to frame 0   */
+
+  long busClocks = encodeFrame( prev, first, pages, out );
+
+  fprintf( stderr, "wrap     : %6ld bus clocks\n", busClocks );
+
+  if( busClocks > worst )
+  {
+    worst = busClocks;
+  }
+  out.push_back( ANIM_END );
+
+  fprintf( stderr, "%d frames, %ld bus clocks, %zu PROGMEM bytes\n",
+           count, total, out.size() );
+  if( worst )
+  {
+    fprintf( stderr, "max fps: %.1f at 100kHz, %.1f at 400kHz\n",
+             100000.0 / worst, 400000.0 / worst );
+  }
+
+  printf( "const uint8_t %s[] PROGMEM =\n{", name );
+
+  for( size_t i = 0; i < out.size(); i++ )
+  {
+    printf( "%s0x%02X,", ( i % 12 ) ? " " : "\n  ", out[i] );
+  }
+  printf( "\n};\n" );
+
+  return 0;
+}
@@ -0,0 +1,57 @@
+/* file: Arduino.h   (host stand-in)
+ *
+ *  just enough of the Arduino core to build the oled_I2C library on a PC,
+ *  for the tests in extras/host. Not for sketches.
+ *
+ *  Dave Harris 2021
+*/
+
+#ifndef _host_Arduino_h_
+#define _host_Arduino_h_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+
+#define BIN   2
+#define DEC  10
+
+
+class Stream                              /* subclass to feed read()        */
+{
+  public:
+
+    virtual int    available()          { return 0; }
+    virtual int    read()               { return -1; }
+    virtual size_t write( uint8_t )     { return 1; }
+
+    size_t print( const char * str );
+    size_t print( unsigned long num, int base = DEC );
+    size_t println( const char * str = "" );
+    size_t println( unsigned long num, int base = DEC );
+};
+
+
+class HardwareSerial : public Stream     /* output is dropped              */
+{
+  public:
+
+    void begin( unsigned long ) {}
+};
+
+extern HardwareSerial Serial;
+
+
+unsigned long millis();                   /* host clock, see host.h         */
+unsigned long micros();
+void delay( unsigned long ms );
+void delayMicroseconds( unsigned int us );
+
+
+#endif /* _host_Arduino_h_ */
@@ -0,0 +1,129 @@
+/* file: anim_test.cpp
+ *
+ *  host test of OLED_Anim PROGMEM play: each frame stays on screen for its
+ *  slot, looping goes through the wrap frame with no clearScreen(), and
+ *  arrays without a wrap frame still loop.
+ *
+ *  Dave Harris 2021
+*/
+
+#include "oled_model.h"
+#include "oled_Anim.h"
+
+
+static const uint8_t anim[] PROGMEM =      /* as extras/anim_encode makes  */
+{
+  0, 0, 2, 0xAA, 0x55,                     /* frame 0, from clear          */
+  ANIM_FRAME_END,
+  0, 0, 1, 0x0F,   3, 5, 1, 0xFF,          /* frame 1                      */
+  ANIM_FRAME_END,
+  ANIM_LOOP,
+  0, 0, 1, 0xAA,   3, 5, 1, 0x00,          /* wrap, frame 1 to frame 0     */
+  ANIM_FRAME_END,
+  ANIM_END
+};
+
+static const uint8_t noWrap[] PROGMEM =    /* made before wrap frames      */
+{
+  0, 0, 2, 0xAA, 0x55,
+  ANIM_FRAME_END,
+  0, 0, 1, 0x0F,   3, 5, 1, 0xFF,
+  ANIM_FRAME_END,
+  ANIM_END
+};
+
+
+static OLED_Model * m;
+
+
+
+/*------------------------------- frameIs() ---------------------------------
+ *
+ * screen shows frame 0 or frame 1
+*/
+
+static bool frameIs( int frame )
+{
+  return m->ram[0][0] == ( frame ? 0x0F : 0xAA ) &&
+         m->ram[0][1] == 0x55 &&
+         m->ram[3][5] == ( frame ? 0xFF : 0x00 );
+}
+
+
+
+/*------------------------------- slot() ------------------------------------
+ *
+ * wait for the next frame slot, tick. Bytes sent in the tick.
+*/
+
+static long slot( OLED_Anim & anim )
+{
+  hostAdvance( 100000 );
+
+  long bytes = m->bytes;
+
+  anim.tick();
+
+  return m->bytes - bytes;
+}
+
+
+
+int main()
+{
+  modelReset();
+
+  m = & modelAdd( OLED_I2C_ADR );
+
+  OLED_I2C  oled;
+  OLED_Anim player( oled );
+
+  oled.init( & Serial );
+  oled.clearScreen();
+
+                              /* loop, 10 fps ------------------------------*/
+  player.play( anim, 10, true );
+
+  player.tick();
+  CHECK( frameIs( 0 ) );
+
+  bool  shows  = true;
+  long  most   = 0;
+
+  for( int i = 1; i < 9; i++ )             /* 1, 0 (wrap), 1, 0, ...       */
+  {
+    long bytes = slot( player );
+
+    shows &= frameIs( i & 1 );
+    most   = bytes > most ? bytes : most;
+  }
+  CHECK( shows );
+  CHECK( most < 40 );                      /* spans only, never a clear    */
+  CHECK( player.frames() == 9 );
+  CHECK( player.dropped() == 0 );
+
+                              /* no loop, stops at ANIM_LOOP ---------------*/
+  oled.clearScreen();
+  player.play( anim, 10, false );
+
+  player.tick();
+  slot( player );
+
+  CHECK( frameIs( 1 ) );
+  CHECK( ! player.tick() );
+  CHECK( player.frames() == 2 );
+
+                              /* no wrap frame, clear has its own slot -----*/
+  oled.clearScreen();
+  player.play( noWrap, 10, true );
+
+  player.tick();
+  slot( player );
+  CHECK( frameIs( 1 ) );                   /* last frame shows             */
+
+  CHECK( slot( player ) > 1000 );          /* clear                        */
+  slot( player );
+  CHECK( frameIs( 0 ) );
+
+  return hostResult( "anim_test" );
+}
@@ -0,0 +1,47 @@
+/* file: avr/io.h   (host stand-in)
+ *
+ *  port registers for the host build. A register can have hooks, so a
+ *  test can model the pins behind it, e.g. the soft I2C lanes.
+ *
+ *  Dave Harris 2021
+*/
+
+#ifndef _host_avr_io_h_
+#define _host_avr_io_h_
+
+#include <stdint.h>
+
+
+struct HostReg
+{
+  uint8_t   val = 0;
+
+  void    ( * onWrite )( uint8_t val ) = nullptr;   /* after each write     */
+  uint8_t ( * onRead )()               = nullptr;   /* pin levels, say      */
+
+  operator uint8_t() const { return onRead ? onRead() : val; }
+
+  HostReg & operator=( uint8_t v )
+  {
+    val = v;
+
+    if( onWrite )
+    {
+      onWrite( v );
+    }
+    return * this;
+  }
+
+  HostReg & operator|=( uint8_t v ) { return * this = val | v; }
+  HostReg & operator&=( uint8_t v ) { return * this = val & v; }
+};
+
+extern HostReg PORTB, DDRB, PINB;
+extern HostReg PORTC, DDRC, PINC;
+extern HostReg PORTD, DDRD, PIND;
+
+
+#define __builtin_avr_delay_cycles( n )  ( (void) ( n ) )   /* no time */
+
+
+#endif /* _host_avr_io_h_ */
@@ -0,0 +1,24 @@
+/* file: avr/pgmspace.h   (host stand-in)
+ *
+ *  flash is plain memory on the host
+ *
+ *  Dave Harris 2021
+*/
+
+#ifndef _host_avr_pgmspace_h_
+#define _host_avr_pgmspace_h_
+
+#include <stdint.h>
+#include <string.h>
+
+
+#define PROGMEM
+#define PSTR( s )            ( s )
+
+#define pgm_read_byte( p )   ( * (const uint8_t *) ( p ) )
+
+#define memcpy_P             memcpy
+#define strlen_P             strlen
+
+
+#endif /* _host_avr_pgmspace_h_ */
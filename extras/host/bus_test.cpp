@@ -0,0 +1,129 @@
+/* file: bus_test.cpp
+ *
+ *  host test of OLED_Bus: three displays share the bus model, one on the
+ *  main bus and two with the same address behind a TCA9548A mux. Each
+ *  does its own writes, queued and sent in chunks taking turns. At the
+ *  end each display's RAM and commands must be what the same writes give
+ *  when that display is alone on the bus, written directly.
+ *
+ *  Dave Harris 2021
+*/
+
+#include "oled_model.h"
+#include "oled_Bus.h"
+
+
+struct Where
+{
+  uint8_t adr;
+  int8_t  muxChan;
+};
+
+static const Where where[3] =
+{
+  { 0x3D, MODEL_NO_MUX },
+  { 0x3C, 0 },
+  { 0x3C, 3 }
+};
+
+
+
+/*------------------------------- work() ------------------------------------
+ *
+ * writes for display id, different on each display
+*/
+
+static void work( OLED_I2C & oled, uint8_t id )
+{
+  char    txt[] = "display 0";
+  uint8_t span[100];
+
+  txt[8] += id;
+
+  for( uint8_t i = 0; i < sizeof(span); i++ )
+  {
+    span[i] = i * ( id + 3 );
+  }
+
+  oled.init( & Serial );
+  oled.putRAM( txt, 2, id );
+  oled.contrast( 100 + id, true );
+  oled.putPROG( PSTR("on the bus"), 4, 4 + id );
+  oled.putSpan( 7, 20 + id, span, sizeof(span) );
+  oled.execute( OLED_I2C::DISPLAY_INVERSE, true );
+  oled.putRAM( "end", 17, 3 );
+}
+
+
+
+int main()
+{
+  OLED_Model ref[3];
+
+  for( uint8_t id = 0; id < 3; id++ )     /* each alone, direct writes     */
+  {
+    modelReset();
+
+    OLED_Model & m = modelAdd( where[id].adr );
+    OLED_I2C     oled( where[id].adr );
+
+    work( oled, id );
+
+    ref[id] = m;
+  }
+
+  static const struct { uint8_t chunk; OLED_Bus::SCHED_t sched; } runs[] =
+  {
+    { 32,  OLED_Bus::ROUND_ROBIN },
+    { 1,   OLED_Bus::ROUND_ROBIN },
+    { 0,   OLED_Bus::ROUND_ROBIN },       /* taken as 1                    */
+    { 200, OLED_Bus::ROUND_ROBIN },
+    { 32,  OLED_Bus::PRIORITY }
+  };
+
+  for( auto & run : runs )
+  {
+    modelReset();
+
+    OLED_Model * m[3];
+    OLED_I2C   * oled[3];
+    OLED_Bus     bus( run.chunk, run.sched );
+
+    for( uint8_t id = 0; id < 3; id++ )
+    {
+      m[id]    = & modelAdd( where[id].adr, where[id].muxChan );
+      oled[id] = new OLED_I2C( where[id].adr );
+
+      if( where[id].muxChan == MODEL_NO_MUX )
+      {
+        bus.add( * oled[id], id );
+      }
+      else
+      {
+        bus.add( * oled[id], id, MODEL_MUX_ADR, where[id].muxChan );
+      }
+    }
+
+    for( uint8_t id = 0; id < 3; id++ )   /* queues fill, polls interleave */
+    {
+      work( * oled[id], id );
+    }
+    bus.flush();
+
+    for( uint8_t id = 0; id < 3; id++ )
+    {
+      CHECK( memcmp( m[id]->ram, ref[id].ram, sizeof(ref[id].ram) ) == 0 );
+      CHECK( m[id]->cmds == ref[id].cmds );
+      CHECK( bus.stats( id ).count > 0 );
+
+      delete oled[id];
+    }
+    CHECK( modelNacks == 0 );
+
+    printf( "chunk %3u %s: %ld bytes, %ld transactions\n", run.chunk,
+            run.sched == OLED_Bus::PRIORITY ? "priority   " : "round robin",
+            modelBusBytes, modelBusTxns );
+  }
+
+  return hostResult( "bus_test" );
+}
@@ -0,0 +1,77 @@
+/* file: bytes_test.cpp
+ *
+ *  host test: bytes and transactions on the bus for the basic writes, with
+ *  the window commands merged into the data transaction, and what ends up
+ *  in display RAM.
+ *
+ *  Before the merge (worked by hand, SSD1306):
+ *    putRAM of 5 chars:  46 bytes, 6 transactions
+ *    clearScreen():    1088 bytes, 16 transactions
+ *
+ *  Dave Harris 2021
+*/
+
+#include "oled_model.h"
+#include "oled_I2C.h"
+
+
+
+int main()
+{
+  modelReset();
+
+  OLED_Model & m = modelAdd( OLED_I2C_ADR );
+  OLED_I2C     oled;
+
+  oled.init( & Serial );
+  CHECK( modelNacks == 0 );
+
+                              /* putRAM of 5 chars: adr, 4 Co window cmds,  */
+  m.count0();                 /*   data ctrl, 30 bytes                      */
+  oled.putRAM( "Hello", 3, 2 );
+
+  CHECK( m.txns == 1 );
+  CHECK( m.bytes == 1 + 8 + 1 + 5 * 6 );
+
+  bool same = true;
+
+  for( uint8_t i = 0; i < 5 * 6; i++ )
+  {
+    same &= m.ram[2][18 + i] == pgm_read_byte( & FONT["Hello"[i / 6] - ' '][i % 6] );
+  }
+  CHECK( same );
+
+  printf( "putRAM 5 chars:   %ld bytes, %ld transaction\n", m.bytes, m.txns );
+
+                              /* clearScreen(): one transaction, wraps      */
+  m.count0();                 /*   page to page                             */
+  oled.clearScreen();
+
+  CHECK( m.txns == 1 );
+  CHECK( m.bytes == 1 + 8 + 1 + 1024 );
+
+  uint8_t zero[8][128] = { { 0 } };
+
+  CHECK( memcmp( m.ram, zero, sizeof(zero) ) == 0 );
+
+  printf( "clearScreen():  %ld bytes, %ld transaction\n", m.bytes, m.txns );
+
+                              /* putSpan() of 10                            */
+  uint8_t span[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+  m.count0();
+  oled.putSpan( 7, 100, span, sizeof(span) );
+
+  CHECK( m.txns == 1 && m.bytes == 10 + 10 );
+  CHECK( memcmp( & m.ram[7][100], span, sizeof(span) ) == 0 );
+
+                              /* held commands go out with the next call    */
+  m.count0();
+  oled.contrast( 200, true );
+  oled.execute( OLED_I2C::DISPLAY_INVERSE );
+
+  CHECK( m.txns == 1 && m.bytes == 5 );
+  CHECK( m.cmds == std::vector<uint8_t>( { 0x81, 200, 0xA7 } ) );
+
+  return hostResult( "bytes_test" );
+}
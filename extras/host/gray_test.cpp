@@ -0,0 +1,70 @@
+/* file: gray_test.cpp
+ *
+ *  host test of OLED_Gray bus limit: maxHz() is the highest refresh rate
+ *  at which each plane switch fits in its step, 1/3 of a refresh. At that
+ *  rate grayscale keeps up on the bus model clock, and identical planes
+ *  give 0 with no overflow.
+ *
+ *  Dave Harris 2021
+*/
+
+#include "oled_model.h"
+#include "oled_Gray.h"
+
+
+static uint8_t msb[1024] PROGMEM;
+static uint8_t lsb[1024] PROGMEM;
+
+
+
+/*------------------------------- run() -------------------------------------
+ *
+ * tick for seconds of host clock, true if still in grayscale
+*/
+
+static bool run( OLED_Gray & gray, uint8_t seconds )
+{
+  uint64_t end = hostNanos + seconds * 1000000000ULL;
+
+  while( hostNanos < end )
+  {
+    gray.tick();
+    hostAdvance( 100 );
+  }
+  return gray.gray();
+}
+
+
+
+int main()
+{
+  modelReset();
+  modelAdd( OLED_I2C_ADR );
+
+  OLED_I2C  oled;
+  OLED_Gray gray( oled );
+
+  oled.init( & Serial );
+
+  for( uint8_t col = 0; col < 128; col++ ) /* page 0 differs, all columns   */
+  {
+    msb[col] = 0xFF;
+  }
+                                           /* adr, 4 Co cmds, ctrl, 128     */
+  uint16_t limit = F_I2C / ( 3 * 9 * ( 1 + 8 + 1 + 128 ) );
+
+  CHECK( gray.show( msb, lsb, limit ) );
+  CHECK( gray.maxHz() == limit );
+  CHECK( run( gray, 3 ) );
+  CHECK( gray.hz() * 10UL >= limit * 9UL );
+
+  printf( "maxHz %u, measured %u\n", gray.maxHz(), gray.hz() );
+
+  CHECK( ! gray.show( msb, lsb, limit + 1 ) ); /* over the limit, 1 bit      */
+
+  CHECK( ! gray.show( msb, msb, 50 ) );    /* same planes, nothing to send  */
+  CHECK( gray.maxHz() == 0 );
+  CHECK( ! gray.tick() );
+
+  return hostResult( "gray_test" );
+}
@@ -0,0 +1,116 @@
+/* file: host.cpp
+ *
+ *  host (PC) stand-ins for the Arduino core, and the test CHECK() count.
+ *  See host.h
+ *
+ *  Dave Harris 2021
+*/
+
+#include "host.h"
+#include "i2c.h"                          /* I2C_ErrorFlag, C linkage       */
+
+
+HostReg PORTB, DDRB, PINB;
+HostReg PORTC, DDRC, PINC;
+HostReg PORTD, DDRD, PIND;
+
+uint8_t I2C_ErrorFlag;
+
+HardwareSerial Serial;
+
+uint64_t hostNanos;
+
+static int checks;
+static int failed;
+
+
+
+/*------------------------------- Stream print ------------------------------
+ *
+ * text through write(), as the Arduino Print class
+*/
+
+size_t Stream::print( const char * str )
+{
+  size_t n = 0;
+
+  while( * str )
+  {
+    n += write( (uint8_t) * str++ );
+  }
+  return n;
+}
+
+
+size_t Stream::print( unsigned long num, int base )
+{
+  char txt[ 8 * sizeof(num) + 1 ];
+  char * p = & txt[ sizeof(txt) - 1 ];
+
+  * p = 0;
+
+  do
+  {
+    * --p = "0123456789ABCDEF"[ num % base ];
+    num  /= base;
+  }
+  while( num );
+
+  return print( p );
+}
+
+
+size_t Stream::println( const char * str )
+{
+  return print( str ) + print( "\r\n" );
+}
+
+
+size_t Stream::println( unsigned long num, int base )
+{
+  return print( num, base ) + print( "\r\n" );
+}
+
+
+
+/*------------------------------- host clock --------------------------------*/
+
+unsigned long millis()                  { return hostNanos / 1000000; }
+unsigned long micros()                  { return hostNanos / 1000; }
+void delay( unsigned long ms )          { hostNanos += ms * 1000000ULL; }
+void delayMicroseconds( unsigned int us ) { hostNanos += us * 1000ULL; }
+void hostAdvance( uint32_t us )         { hostNanos += us * 1000ULL; }
+
+
+
+/*------------------------------- hostCheck() -------------------------------
+ *
+ * count a check, print it if it failed
+*/
+
+bool hostCheck( bool ok, const char * what, const char * file, int line )
+{
+  checks++;
+
+  if( ! ok )
+  {
+    failed++;
+    printf( "%s:%d: FAILED %s\n", file, line, what );
+  }
+  return ok;
+}
+
+
+
+/*------------------------------- hostResult() ------------------------------
+ *
+ * print the result line. 0 if all checks passed, for main() to return.
+*/
+
+int hostResult( const char * test )
+{
+  printf( "%-14s %s, %d checks, %d failed\n", test,
+          failed ? "FAIL" : "ok", checks, failed );
+
+  return failed ? 1 : 0;
+}
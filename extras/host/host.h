@@ -0,0 +1,31 @@
+/* file: host.h
+ *
+ *  host (PC) test support for the oled_I2C library: the clock behind
+ *  millis() and micros(), and CHECK() to count failures.
+ *
+ *  Tests are built and run by run.sh, from the repo root:
+ *    sh extras/host/run.sh
+ *
+ *  Dave Harris 2021
+*/
+
+#ifndef _host_h_
+#define _host_h_
+
+#include <Arduino.h>
+
+
+extern uint64_t hostNanos;                /* host clock, only moves when    */
+                                          /*   told or by I2C model bytes   */
+
+void hostAdvance( uint32_t us );          /* move host clock on             */
+
+
+#define CHECK( cond )  hostCheck( ( cond ), #cond, __FILE__, __LINE__ )
+
+bool hostCheck( bool ok, const char * what, const char * file, int line );
+
+int  hostResult( const char * test );     /* print result, main() returns it*/
+
+
+#endif /* _host_h_ */
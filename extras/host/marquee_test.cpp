@@ -0,0 +1,89 @@
+/* file: marquee_test.cpp
+ *
+ *  host test: marquees only start on a landscape line 0 to CHARS_HIGH-1.
+ *  yPos -1 made page command 0xB0 + 0xFF = 0xAF, DISPLAY_AWAKE. A
+ *  running marquee stops when rotated to portrait. Bytes and bus time
+ *  per tick.
+ *
+ *  Dave Harris 2021
+*/
+
+#include "oled_model.h"
+#include "oled_I2C.h"
+
+
+
+int main()
+{
+  modelReset();
+
+  OLED_Model & m = modelAdd( OLED_I2C_ADR );
+  OLED_I2C     oled;
+
+  oled.init( & Serial );
+
+                              /* off the screen: nothing sent              */
+  m.count0();
+  oled.marqueeRAM( "long string", -1 );
+  oled.marqueeTick();
+  oled.marqueePROG( PSTR("long string"), OLED_I2C::CHARS_HIGH );
+  oled.marqueeTick();
+  oled.marqueeHW( -1 );
+  oled.marqueeHW( OLED_I2C::CHARS_HIGH );
+
+  CHECK( m.bytes == 0 );
+
+                              /* a line: tick writes that page             */
+  oled.marqueeRAM( "long string", 2 );
+
+  for( uint16_t i = 0; i <= OLED_PX_HOR; i++ )  /* string in at column 0 */
+  {
+    oled.marqueeTick();
+  }
+  CHECK( m.ram[2][0] == pgm_read_byte( & FONT['l' - ' '][0] ) );
+
+                              /* per tick: adr, 4 Co window cmds, ctrl,     */
+  m.count0();                 /*   128 columns, one transaction             */
+
+  uint64_t start = hostNanos;
+
+  oled.marqueeTick();
+
+  CHECK( m.txns == 1 && m.bytes == 1 + 8 + 1 + 128 );
+
+  printf( "marqueeTick():   %ld bytes, %ld transaction, %.1fms on the bus\n",
+          m.bytes, m.txns, ( hostNanos - start ) / 1e6 );
+
+  oled.marqueeHW( 3 );
+  CHECK( m.scrolling );
+
+                              /* a bad line leaves the good marquee on     */
+  oled.marqueeHW( -1 );
+  CHECK( m.scrolling );
+
+  oled.marqueeStop();
+  oled.clearScreen();
+  CHECK( ! m.scrolling );
+
+                              /* portrait: ignored                         */
+  oled.rotate( OLED_I2C::ROTATE_90 );
+  oled.clearScreen();
+  m.count0();
+  oled.marqueeRAM( "long string", 1 );
+  oled.marqueeTick();
+
+  CHECK( m.bytes == 0 );
+
+                              /* running marquee stops on rotate to portrait*/
+  oled.rotate( OLED_I2C::ROTATE_0 );
+  oled.marqueeRAM( "long string", 2 );
+  oled.marqueeTick();
+  oled.rotate( OLED_I2C::ROTATE_270 );
+  oled.clearScreen();
+  m.count0();
+  oled.marqueeTick();
+
+  CHECK( m.bytes == 0 );
+
+  return hostResult( "marquee_test" );
+}
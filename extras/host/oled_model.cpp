@@ -0,0 +1,276 @@
+/* file: oled_model.cpp
+ *
+ *  host (PC) stand-in for the I2C bus, i2c.h functions. See oled_model.h
+ *
+ *  Dave Harris 2021
+*/
+
+#include "oled_model.h"
+#include "i2c.h"
+
+#include <list>
+
+
+struct Slot                               /* a display on the bus           */
+{
+  uint8_t    adr;
+  int8_t     muxChan;
+  OLED_Model oled;
+  uint8_t    rx;                          /* what the next byte is          */
+};
+
+enum { RX_CTRL, RX_CO_CMD, RX_CMDS, RX_DATA };
+
+static std::list<Slot>     slots;         /* list, so references stay put   */
+static std::vector<Slot *> to;            /* displays in this transaction   */
+static bool                toMux;         /* this transaction is to the mux */
+static uint8_t             muxMask;       /* mux channels on                */
+
+long modelBusBytes;
+long modelBusTxns;
+long modelNacks;
+
+
+#define BIT_NANOS  ( 1000000000ULL / F_I2C )
+
+
+
+/*------------------------------- modelAdd() --------------------------------
+ *
+ * put a display on the bus, RAM cleared
+*/
+
+OLED_Model & modelAdd( uint8_t adr, int8_t muxChan )
+{
+  slots.push_back( Slot() );
+
+  Slot & s = slots.back();
+
+  memset( & s.oled.ram, 0, sizeof(s.oled.ram) );
+
+  s.adr           = adr;
+  s.muxChan       = muxChan;
+  s.rx            = RX_CTRL;
+  s.oled.page     = 0;
+  s.oled.col      = 0;
+  s.oled.colStart = 0;
+  s.oled.colEnd   = 127;
+  s.oled.scrolling = false;
+  s.oled.count0();
+
+  return s.oled;
+}
+
+
+
+/*------------------------------- model() -----------------------------------
+ *
+ * the display at adr, added if not there yet
+*/
+
+OLED_Model & model( uint8_t adr, int8_t muxChan )
+{
+  for( Slot & s : slots )
+  {
+    if( s.adr == adr && s.muxChan == muxChan )
+    {
+      return s.oled;
+    }
+  }
+  return modelAdd( adr, muxChan );
+}
+
+
+
+void modelReset()
+{
+  slots.clear();
+  to.clear();
+
+  muxMask       = 0;
+  modelBusBytes = 0;
+  modelBusTxns  = 0;
+  modelNacks    = 0;
+}
+
+
+
+/*------------------------------- command() ---------------------------------
+ *
+ * one command byte. Collects args, then does what the display would.
+*/
+
+static void command( OLED_Model & d, uint8_t byt )
+{
+  d.cmds.push_back( byt );
+  d.pend.push_back( byt );
+
+  uint8_t c    = d.pend[0];
+  size_t  args = 0;
+
+  switch( c )
+  {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:  args = 1; break;
+    case 0x21: case 0x22: case 0xA3:             args = 2; break;
+    case 0x29: case 0x2A:                        args = 5; break;
+    case 0x26: case 0x27:                        args = 6; break;
+  }
+
+  if( d.pend.size() < args + 1 )
+  {
+    return;
+  }
+
+  if( c >= 0xB0 && c <= 0xB7 )
+  {
+    d.page = c & 0x07;
+  }
+  else if( c == 0x21 )
+  {
+    d.colStart = d.pend[1] & 0x7F;
+    d.colEnd   = d.pend[2] & 0x7F;
+    d.col      = d.colStart;
+  }
+  else if( c == 0x22 )
+  {
+    d.page = d.pend[1] & 0x07;
+  }
+  else if( c == 0x2F )
+  {
+    d.scrolling = true;
+  }
+  else if( c == 0x2E )
+  {
+    d.scrolling = false;
+  }
+  d.pend.clear();
+}
+
+
+
+/*------------------------------- data() ------------------------------------
+ *
+ * one data byte to RAM, horizontal addressing
+*/
+
+static void data( OLED_Model & d, uint8_t byt )
+{
+  d.ram[d.page][d.col] = byt;
+
+  if( d.col == d.colEnd )
+  {
+    d.col  = d.colStart;
+    d.page = ( d.page + 1 ) & 0x07;
+  }
+  else
+  {
+    d.col = ( d.col + 1 ) & 0x7F;
+  }
+}
+
+
+
+/*------------------------------- i2c.h -------------------------------------*/
+
+void i2c_init()
+{
+}
+
+
+void i2c_start( uint8_t i2c_addr )
+{
+  uint8_t adr = i2c_addr >> 1;
+
+  to.clear();
+
+  modelBusTxns++;
+  modelBusBytes++;
+  hostNanos += 10 * BIT_NANOS;            /* START, adr byte and ACK        */
+
+  toMux = adr == MODEL_MUX_ADR;
+
+  if( toMux )
+  {
+    return;
+  }
+
+  for( Slot & s : slots )
+  {
+    if( s.adr == adr &&
+        ( s.muxChan == MODEL_NO_MUX || ( muxMask >> s.muxChan ) & 1 ) )
+    {
+      s.rx = RX_CTRL;
+      s.oled.txns++;
+      s.oled.bytes++;
+      to.push_back( & s );
+    }
+  }
+
+  if( to.empty() )                        /* nobody ACKed                   */
+  {
+    modelNacks++;
+    I2C_ErrorFlag = 1;
+  }
+}
+
+
+void i2c_byte( uint8_t byt )
+{
+  modelBusBytes++;
+  hostNanos += 9 * BIT_NANOS;
+
+  if( toMux )
+  {
+    muxMask = byt;
+    return;
+  }
+
+  for( Slot * s : to )
+  {
+    s->oled.bytes++;
+
+    switch( s->rx )
+    {
+      case RX_CTRL:
+        s->rx = byt == 0x80 ? RX_CO_CMD
+              : byt == 0x00 ? RX_CMDS
+              :               RX_DATA;    /* 0x40                           */
+        break;
+
+      case RX_CO_CMD:
+        command( s->oled, byt );
+        s->rx = RX_CTRL;
+        break;
+
+      case RX_CMDS:
+        command( s->oled, byt );
+        break;
+
+      case RX_DATA:
+        data( s->oled, byt );
+        break;
+    }
+  }
+}
+
+
+void i2c_stop()
+{
+  hostNanos += BIT_NANOS;
+
+  to.clear();
+  toMux = false;
+}
+
+
+uint8_t i2c_readAck()
+{
+  return 0xFF;
+}
+
+
+uint8_t i2c_readNAck()
+{
+  return 0xFF;
+}
@@ -0,0 +1,62 @@
+/* file: oled_model.h
+ *
+ *  host (PC) stand-in for the I2C bus, in place of i2c.c. Models SSD1306
+ *  displays and a TCA9548A mux on the bus, and counts what goes on it.
+ *
+ *  Each display keeps its RAM, as horizontal addressing with the 0x21
+ *  column window and 0xB0 page, so a test can compare the screen with
+ *  what it should be. Bytes are counted with the address byte, as on the
+ *  wire, and move the host clock on 9 bit times at F_I2C.
+ *
+ *  A display behind the mux gets writes only while its channel is on.
+ *  A display on the main bus gets every write to its address, mux or not,
+ *  as on the wire, so one address on both is a clash.
+ *
+ *  Dave Harris 2021
+*/
+
+#ifndef _oled_model_h_
+#define _oled_model_h_
+
+#include "host.h"
+
+#include <vector>
+
+
+#define MODEL_MUX_ADR   0x70              /* TCA9548A 7 bit address         */
+#define MODEL_NO_MUX    -1                /* display on the main bus        */
+
+
+struct OLED_Model
+{
+  uint8_t ram[8][128];                    /* pages x columns                */
+
+  uint8_t page;                           /* RAM write position             */
+  uint8_t col;
+  uint8_t colStart;                       /* 0x21 window                    */
+  uint8_t colEnd;
+
+  bool    scrolling;                      /* 0x2F on, 0x2E off              */
+
+  long    bytes;                          /* written to it, with adr byte   */
+  long    txns;                           /* START to STOP                  */
+
+  std::vector<uint8_t> cmds;              /* command bytes, in order        */
+  std::vector<uint8_t> pend;              /* command and its args so far    */
+
+  void count0() { bytes = 0; txns = 0; cmds.clear(); }
+};
+
+
+OLED_Model & modelAdd( uint8_t adr, int8_t muxChan = MODEL_NO_MUX ); /* new */
+
+OLED_Model & model( uint8_t adr, int8_t muxChan = MODEL_NO_MUX );
+
+void modelReset();                        /* no displays, counts 0          */
+
+extern long modelBusBytes;                /* all bytes on the bus           */
+extern long modelBusTxns;                 /* all transactions on the bus    */
+extern long modelNacks;                   /* writes no display answered     */
+
+
+#endif /* _oled_model_h_ */
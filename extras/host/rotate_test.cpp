@@ -0,0 +1,130 @@
+/* file: rotate_test.cpp
+ *
+ *  host test of OLED_I2C::transpose8() against a bit by bit reference,
+ *  on every single bit tile and 100000 random tiles, out of place and in
+ *  place. Then portrait text on the bus model: each char cell holds the
+ *  transposed FONT glyph, and clearScreen() clears the whole screen.
+ *
+ *  Dave Harris 2021
+*/
+
+#include "oled_model.h"
+#include "oled_I2C.h"
+
+
+
+/*------------------------------- naive() -----------------------------------
+ *
+ * out[j] bit i = in[i] bit j, one bit at a time
+*/
+
+static void naive( const uint8_t in[8], uint8_t out[8] )
+{
+  memset( out, 0, 8 );
+
+  for( uint8_t i = 0; i < 8; i++ )
+  {
+    for( uint8_t j = 0; j < 8; j++ )
+    {
+      if( in[i] >> j & 1 )
+      {
+        out[j] |= 1 << i;
+      }
+    }
+  }
+}
+
+
+
+/*------------------------------- same() ------------------------------------
+ *
+ * transpose8() matches naive(), out of place and in place
+*/
+
+static bool same( const uint8_t in[8] )
+{
+  uint8_t ref[8];
+  uint8_t out[8];
+  uint8_t io[8];
+
+  naive( in, ref );
+  OLED_I2C::transpose8( in, out );
+
+  memcpy( io, in, 8 );
+  OLED_I2C::transpose8( io, io );
+
+  return memcmp( out, ref, 8 ) == 0 && memcmp( io, ref, 8 ) == 0;
+}
+
+
+
+int main()
+{
+  bool    ok = true;
+  uint8_t in[8];
+
+  for( uint8_t bit = 0; bit < 64; bit++ )  /* every single bit            */
+  {
+    memset( in, 0, 8 );
+    in[bit / 8] = 1 << ( bit % 8 );
+
+    ok &= same( in );
+  }
+  CHECK( ok );
+
+  srand( 1 );
+
+  for( long n = 0; n < 100000; n++ )       /* random tiles                */
+  {
+    for( uint8_t i = 0; i < 8; i++ )
+    {
+      in[i] = rand();
+    }
+    ok &= same( in );
+  }
+  CHECK( ok );
+
+                              /* portrait text                             */
+  modelReset();
+
+  OLED_Model & m = modelAdd( OLED_I2C_ADR );
+  OLED_I2C     oled;
+
+  oled.rotate( OLED_I2C::ROTATE_90 );
+  oled.init( & Serial );
+
+  CHECK( oled.charsWide() == OLED_PX_VERT / 8 && oled.charsHigh() == OLED_PX_HOR / 8 );
+
+  oled.putRAM( "AB", 2, 5 );
+
+  for( uint8_t k = 0; k < 2; k++ )        /* cell x is page, y is columns */
+  {
+    uint8_t tile[8] = { 0 };
+    uint8_t cell[8];
+
+    memcpy_P( tile, FONT[ "AB"[k] - ' ' ], sizeof(FONT[0]) );
+    naive( tile, cell );
+
+    CHECK( memcmp( & m.ram[2 + k][5 * 8], cell, 8 ) == 0 );
+  }
+
+  uint8_t zero[8][128] = { { 0 } };
+                              /* portrait clear, after a char's 8 col tile */
+  memset( m.ram, 0xFF, sizeof(m.ram) );
+  oled.putRAM( "A", 0, 0 );
+  oled.clearScreen();
+
+  CHECK( memcmp( m.ram, zero, sizeof(zero) ) == 0 );
+
+                              /* clear right after rotate(), landscape     */
+  oled.rotate( OLED_I2C::ROTATE_0 );        /*   window from putRAM()      */
+  oled.putRAM( "A", 3, 2 );
+  oled.rotate( OLED_I2C::ROTATE_90 );
+
+  memset( m.ram, 0xFF, sizeof(m.ram) );
+  oled.clearScreen();
+
+  CHECK( memcmp( m.ram, zero, sizeof(zero) ) == 0 );
+
+  return hostResult( "rotate_test" );
+}
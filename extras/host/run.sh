@@ -0,0 +1,55 @@
+#!/bin/sh
+#
+# build and run the host (PC) tests of the oled_I2C library.
+# From the repo root:   sh extras/host/run.sh
+#
+# The library is built for the PC with the stand-ins in extras/host.
+# Exits non-zero if a test fails.
+#
+# Dave Harris 2021
+
+cd "$(dirname "$0")/../.." || exit 1
+
+CXX="${CXX:-g++} -std=c++11 -Wall -Wextra -DF_CPU=16000000UL -Iextras/host -Isrc"
+OUT=$(mktemp -d)
+FAIL=0
+
+trap 'rm -rf "$OUT"' EXIT
+
+run()       # name, sources...
+{
+  name=$1
+  shift
+
+  if $CXX -o "$OUT/$name" "$@"; then
+    "$OUT/$name" || FAIL=1
+  else
+    echo "$name does not build"
+    FAIL=1
+  fi
+}
+
+LIB="src/oled_I2C.cpp src/oled_Bus.cpp extras/host/host.cpp"
+BUS="$LIB extras/host/oled_model.cpp"
+
+run si2c_test     -DOLED_SOFT_I2C extras/host/si2c_test.cpp $LIB -x c++ src/soft_i2c.c
+run bytes_test    extras/host/bytes_test.cpp $BUS
+run anim_test     extras/host/anim_test.cpp src/oled_Anim.cpp $BUS
+run bus_test      extras/host/bus_test.cpp $BUS
+run marquee_test  extras/host/marquee_test.cpp $BUS
+run rotate_test   extras/host/rotate_test.cpp $BUS
+run gray_test     extras/host/gray_test.cpp src/oled_Gray.cpp $BUS
+
+for pages in 1 2 8; do     # OLED_STRIP_PAGES edited in a copy, as a user would
+  DIR="$OUT/strip$pages"
+  mkdir "$DIR"
+  sed "s/^#define OLED_STRIP_PAGES  1 /#define OLED_STRIP_PAGES  $pages /" \
+    src/oled_Strip.h > "$DIR/oled_Strip.h"
+  cp src/oled_Strip.cpp "$DIR"
+  run strip_test$pages -iquote "$DIR" extras/host/strip_test.cpp "$DIR/oled_Strip.cpp" $BUS
+done
+
+$CXX -o "$OUT/oled_stream_send" extras/oled_stream_send/oled_stream_send.cpp || FAIL=1
+run loopback_test extras/oled_stream_send/loopback_test.cpp src/oled_Stream.cpp $BUS -lutil
+
+exit $FAIL
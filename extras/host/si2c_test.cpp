@@ -0,0 +1,265 @@
+/* file: si2c_test.cpp
+ *
+ *  host test of soft_i2c.c at pin level. DDRD writes are decoded as the
+ *  bus lines would be, with a pull-up on each pin: START, 8 data bits
+ *  clocked in on SCL rising, ACK driven by a modelled display on each
+ *  lane, STOP. The bytes seen on each lane are checked.
+ *
+ *  Built with OLED_SOFT_I2C by run.sh
+ *
+ *  Dave Harris 2021
+*/
+
+#include "host.h"
+#include "oled_I2C.h"
+#include "oled_Bus.h"
+
+#include <vector>
+
+
+typedef std::vector<uint8_t> Txn;         /* adr byte, then the rest        */
+
+
+#define SCL_BIT   ( 1 << SI2C_SCL )
+
+
+struct Lane                               /* one SDA lane and its display   */
+{
+  bool    present = true;                 /* display there to ACK           */
+  bool    inTxn   = false;
+  bool    acking  = false;                /* display holds SDA low          */
+  bool    ackClk  = false;                /* 9th clock is high              */
+  uint8_t bits    = 0;
+  uint8_t nBits   = 0;
+
+  std::vector<Txn> txns;
+};
+
+static Lane    lane[8];
+static uint8_t lastLines = 0xFF;
+
+
+
+/*------------------------------- lines() -----------------------------------
+ *
+ * pin levels: high unless DDR drives it low or a display ACKs
+*/
+
+static uint8_t lines()
+{
+  uint8_t low = DDRD.val;
+
+  for( uint8_t n = 0; n < 8; n++ )
+  {
+    if( lane[n].acking )
+    {
+      low |= 1 << n;
+    }
+  }
+  return ~low;
+}
+
+
+
+/*------------------------------- ddrWritten() ------------------------------
+ *
+ * decode what the DDR write did to each lane
+*/
+
+static void ddrWritten( uint8_t )
+{
+  uint8_t now  = lines();
+  bool    sclH = now & SCL_BIT;
+  bool    rise = sclH && ! ( lastLines & SCL_BIT );
+  bool    fall = ! sclH && ( lastLines & SCL_BIT );
+
+  for( uint8_t n = 0; n < 8; n++ )
+  {
+    if( n == SI2C_SCL )
+    {
+      continue;
+    }
+    Lane &  l     = lane[n];
+    uint8_t bit   = 1 << n;
+    bool    sda   = now & bit;
+    bool    sdaWas = lastLines & bit;
+
+    if( sclH && ! rise && sda != sdaWas )  /* SDA moved with SCL high      */
+    {
+      if( ! sda )                          /* START                        */
+      {
+        l.inTxn = true;
+        l.nBits = 0;
+        l.txns.push_back( Txn() );
+      }
+      else                                 /* STOP                         */
+      {
+        l.inTxn = false;
+      }
+      continue;
+    }
+
+    if( ! l.inTxn )
+    {
+      continue;
+    }
+
+    if( rise )
+    {
+      if( l.nBits < 8 )
+      {
+        l.bits = ( l.bits << 1 ) | sda;
+        l.nBits++;
+      }
+      else
+      {
+        l.ackClk = true;
+      }
+    }
+    else if( fall )
+    {
+      if( l.ackClk )                       /* ACK clock done, release SDA  */
+      {
+        l.acking = false;
+        l.ackClk = false;
+        l.nBits  = 0;
+      }
+      else if( l.nBits == 8 )              /* byte in, ACK it if for us    */
+      {
+        Txn & t = l.txns.back();
+
+        t.push_back( l.bits );
+
+        l.acking = l.present && t[0] == OLED_I2C_ADR << 1;
+      }
+    }
+  }
+  lastLines = lines();
+}
+
+
+
+static uint8_t pinRead()
+{
+  return lines();
+}
+
+
+
+/*------------------------------- reset() -----------------------------------
+ *
+ * clear what the lanes saw, all displays present
+*/
+
+static void reset()
+{
+  for( Lane & l : lane )
+  {
+    l = Lane();
+  }
+  SI2C_NAckMask = 0;
+  I2C_ErrorFlag = 0;
+}
+
+
+
+int main()
+{
+  DDRD.onWrite = ddrWritten;
+  PIND.onRead  = pinRead;
+
+  const uint8_t adr = OLED_I2C_ADR << 1;
+
+                              /* one lane, si2c_byte() ---------------------*/
+  reset();
+  si2c_init( 1 << 3 );
+  si2c_start( adr );
+  si2c_byte( 0x00 );
+  si2c_byte( 0xA5 );
+  si2c_stop();
+
+  CHECK( lane[3].txns.size() == 1 && lane[3].txns[0] == Txn( { adr, 0x00, 0xA5 } ) );
+  CHECK( lane[4].txns.empty() );
+  CHECK( SI2C_NAckMask == 0 && I2C_ErrorFlag == 0 );
+
+                              /* three lanes, si2c_byteLanes() -------------*/
+  reset();
+  si2c_lanes( 0x38 );
+  si2c_start( adr );
+  si2c_byte( 0x40 );
+
+  uint8_t byts[8] = { 0, 0, 0, 0x11, 0x22, 0x81, 0xEE, 0xEE };
+
+  si2c_byteLanes( byts );
+  si2c_byte( 0x5A );
+  si2c_stop();
+
+  CHECK( lane[3].txns.size() == 1 && lane[3].txns[0] == Txn( { adr, 0x40, 0x11, 0x5A } ) );
+  CHECK( lane[4].txns.size() == 1 && lane[4].txns[0] == Txn( { adr, 0x40, 0x22, 0x5A } ) );
+  CHECK( lane[5].txns.size() == 1 && lane[5].txns[0] == Txn( { adr, 0x40, 0x81, 0x5A } ) );
+  CHECK( lane[6].txns.empty() );           /* not selected                 */
+  CHECK( SI2C_NAckMask == 0 );
+
+                              /* missing display NACKs ---------------------*/
+  reset();
+  lane[5].present = false;
+  si2c_start( adr );
+  si2c_byte( 0x00 );
+  si2c_stop();
+
+  CHECK( SI2C_NAckMask == ( 1 << 5 ) );
+  CHECK( I2C_ErrorFlag == 1 );
+  CHECK( lane[3].txns.size() == 1 && lane[3].txns[0].size() == 2 );
+
+                              /* init() keeps lanes chosen before it -------*/
+  reset();
+  si2c_init( SI2C_SDA );                   /* as I2C_INIT()                */
+  si2c_start( adr );
+  si2c_stop();
+
+  CHECK( lane[3].txns.size() == 1 && lane[4].txns.size() == 1 &&
+         lane[5].txns.size() == 1 );
+
+  reset();
+  OLED_I2C oled;
+
+  oled.lanes( 0x30 );
+  oled.init( & Serial );
+
+  CHECK( lane[3].txns.empty() );
+  CHECK( ! lane[4].txns.empty() && lane[4].txns == lane[5].txns );
+  CHECK( ! lane[4].txns.empty() && lane[4].txns[0].size() > 3 &&
+         lane[4].txns[0][1] == 0x00 &&
+         lane[4].txns[0][2] == OLED_I2C::DISPLAY_SLEEP );
+
+                              /* putSpanLanes() -----------------------------*/
+  reset();
+  uint8_t four[3] = { 1, 2, 3 };
+  uint8_t five[3] = { 0xF0, 0x0F, 0xFF };
+  uint8_t * dat[8] = { nullptr, nullptr, nullptr, nullptr, four, five };
+
+  oled.putSpanLanes( 2, 10, dat, 3 );
+
+  Txn win = { adr, 0x80, 0xB2, 0x80, 0x21, 0x80, 10, 0x80, 12, 0x40 };
+  Txn t4  = win;
+  Txn t5  = win;
+
+  t4.insert( t4.end(), four, four + 3 );
+  t5.insert( t5.end(), five, five + 3 );
+
+  CHECK( lane[4].txns.size() == 1 && lane[4].txns[0] == t4 );
+  CHECK( lane[5].txns.size() == 1 && lane[5].txns[0] == t5 );
+  CHECK( SI2C_NAckMask == 0 );
+
+                              /* on OLED_Bus: ignored, nothing sent         */
+  OLED_Bus bus;
+
+  bus.add( oled );
+  reset();
+  oled.putSpanLanes( 2, 10, dat, 3 );
+
+  CHECK( lane[4].txns.empty() && lane[5].txns.empty() );
+  CHECK( ! bus.poll() );
+
+  return hostResult( "si2c_test" );
+}
@@ -0,0 +1,271 @@
+/* file: strip_test.cpp
+ *
+ *  host test of OLED_Strip against a full frame reference: random scenes
+ *  of every primitive, on and off, partly or wholly off screen, drawn
+ *  strip by strip on the bus model and pixel by pixel into a 1 KB frame.
+ *  The display RAM must match the frame, and each draw() must send one
+ *  transaction per strip.
+ *
+ *  run.sh builds it with OLED_STRIP_PAGES 1, 2 and 8, each edited into a
+ *  copy of oled_Strip.h and built with a copy of oled_Strip.cpp.
+ *
+ *  Dave Harris 2021
+*/
+
+#include "oled_model.h"
+#include "oled_Strip.h"
+
+#include <vector>
+
+
+static uint8_t ref[8][128];               /* full frame reference           */
+
+
+enum { PIXEL, HLINE, VLINE, LINE, RECT, FILL, TEXT, KINDS };
+
+struct Op
+{
+  uint8_t kind;
+  int16_t a, b, c, d;
+  bool    on;
+  char    str[12];
+};
+
+static std::vector<Op> ops;               /* the scene                      */
+
+
+
+/*------------------------------- reference ---------------------------------
+ *
+ * the primitives drawn one pixel at a time, clipped to the screen
+*/
+
+static void rPixel( int x, int y, bool on )
+{
+  if( x < 0 || x >= 128 || y < 0 || y >= 64 )
+  {
+    return;
+  }
+  if( on )
+  {
+    ref[y / 8][x] |= 1 << ( y & 7 );
+  }
+  else
+  {
+    ref[y / 8][x] &= ~( 1 << ( y & 7 ) );
+  }
+}
+
+
+static void rLine( int x0, int y0, int x1, int y1, bool on )  /* Bresenham */
+{
+  int dx  = abs( x1 - x0 );
+  int dy  = -abs( y1 - y0 );
+  int sx  = x0 < x1 ? 1 : -1;
+  int sy  = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+
+  for( ;; )
+  {
+    rPixel( x0, y0, on );
+
+    if( x0 == x1 && y0 == y1 )
+    {
+      break;
+    }
+    int e2 = 2 * err;
+
+    if( e2 >= dy )
+    {
+      err += dy;
+      x0  += sx;
+    }
+    if( e2 <= dx )
+    {
+      err += dx;
+      y0  += sy;
+    }
+  }
+}
+
+
+static void rFill( int x, int y, int w, int h, bool on )
+{
+  for( int i = x; i < x + w; i++ )
+  {
+    for( int j = y; j < y + h; j++ )
+    {
+      rPixel( i, j, on );
+    }
+  }
+}
+
+
+static void rRect( int x, int y, int w, int h, bool on )
+{
+  if( w <= 0 || h <= 0 )
+  {
+    return;
+  }
+  for( int i = x; i < x + w; i++ )
+  {
+    rPixel( i, y, on );
+    rPixel( i, y + h - 1, on );
+  }
+  for( int j = y; j < y + h; j++ )
+  {
+    rPixel( x, j, on );
+    rPixel( x + w - 1, j, on );
+  }
+}
+
+
+static void rText( int x, int y, const char * str )
+{
+  for( ; * str; str++ )
+  {
+    for( int col = 0; col < 6; col++, x++ )
+    {
+      uint8_t bits = pgm_read_byte( & FONT[ * str - ' ' ][col] );
+
+      for( int row = 0; row < 8; row++ )
+      {
+        if( bits >> row & 1 )
+        {
+          rPixel( x, y + row, true );
+        }
+      }
+    }
+  }
+}
+
+
+
+/*------------------------------- scene() -----------------------------------
+ *
+ * the draw function: every op, through the strip primitives
+*/
+
+static void scene( OLED_Strip & s )
+{
+  for( auto & o : ops )
+  {
+    switch( o.kind )
+    {
+      case PIXEL: s.pixel( o.a, o.b, o.on );             break;
+      case HLINE: s.hline( o.a, o.b, o.c, o.on );        break;
+      case VLINE: s.vline( o.a, o.b, o.c, o.on );        break;
+      case LINE:  s.line( o.a, o.b, o.c, o.d, o.on );    break;
+      case RECT:  s.rect( o.a, o.b, o.c, o.d, o.on );    break;
+      case FILL:  s.fillRect( o.a, o.b, o.c, o.d, o.on ); break;
+      case TEXT:  s.text( o.a, o.b, o.str );             break;
+    }
+  }
+}
+
+
+
+/*------------------------------- refScene() --------------------------------
+ *
+ * the same ops into the reference frame
+*/
+
+static void refScene()
+{
+  memset( ref, 0, sizeof(ref) );
+
+  for( auto & o : ops )
+  {
+    switch( o.kind )
+    {
+      case PIXEL: rPixel( o.a, o.b, o.on );           break;
+      case HLINE: rFill( o.a, o.b, o.c, 1, o.on );    break;
+      case VLINE: rFill( o.a, o.b, 1, o.c, o.on );    break;
+      case LINE:  rLine( o.a, o.b, o.c, o.d, o.on );  break;
+      case RECT:  rRect( o.a, o.b, o.c, o.d, o.on );  break;
+      case FILL:  rFill( o.a, o.b, o.c, o.d, o.on );  break;
+      case TEXT:  rText( o.a, o.b, o.str );           break;
+    }
+  }
+}
+
+
+
+/*------------------------------- randomOp() --------------------------------
+ *
+ * any primitive, reaching off every edge of the screen
+*/
+
+static Op randomOp()
+{
+  Op o;
+
+  o.kind = rand() % KINDS;
+  o.a    = rand() % 180 - 30;
+  o.b    = rand() % 100 - 20;
+  o.c    = rand() % 180 - 30;
+  o.d    = rand() % 100 - 20;
+  o.on   = rand() % 4 != 0;
+
+  if( o.kind == HLINE || o.kind == VLINE || o.kind == RECT || o.kind == FILL )
+  {
+    o.c = rand() % 90 - 5;                /* sizes, some 0 or negative      */
+    o.d = rand() % 60 - 5;
+  }
+
+  int len = rand() % ( sizeof(o.str) - 1 );
+
+  for( int i = 0; i < len; i++ )
+  {
+    o.str[i] = ' ' + rand() % 95;
+  }
+  o.str[len] = 0;
+
+  return o;
+}
+
+
+
+int main()
+{
+  modelReset();
+
+  OLED_Model & m = modelAdd( OLED_I2C_ADR );
+  OLED_I2C     oled;
+  OLED_Strip   strip( oled );
+
+  oled.init( & Serial );
+  srand( 1 );
+
+  const long strips = 8 / OLED_STRIP_PAGES;
+
+  int  wrong   = 0;
+  bool txnsOk  = true;
+  bool bytesOk = true;
+
+  for( int t = 0; t < 500; t++ )
+  {
+    ops.clear();
+
+    for( int n = 1 + rand() % 20; n > 0; n-- )
+    {
+      ops.push_back( randomOp() );
+    }
+
+    m.count0();
+    strip.draw( scene );
+    refScene();
+                                          /* adr, 4 Co window cmds, ctrl    */
+    wrong   += memcmp( m.ram, ref, sizeof(ref) ) != 0;
+    txnsOk  &= m.txns == strips;
+    bytesOk &= m.bytes == strips * ( 1 + 8 + 1 + OLED_STRIP_PAGES * 128 );
+  }
+  CHECK( wrong == 0 );
+  CHECK( txnsOk );
+  CHECK( bytesOk );
+
+  printf( "%d page strips: %ld bytes, %ld transactions, %d of 500 wrong\n",
+          OLED_STRIP_PAGES, m.bytes, m.txns, wrong );
+
+  return hostResult( "strip_test" );
+}
@@ -0,0 +1,389 @@
+/* file: loopback_test.cpp
+ *
+ *  host test of OLED_Stream with the PC sender, oled_stream_send, over a
+ *  pty. This program is the board: OLED_Stream on the host build of the
+ *  library, with the extras/host bus model as the display.
+ *
+ *  The serial line is modelled on the host clock. Bytes from the pty go
+ *  over the wire at the baud rate into a 64 byte receive buffer, as the
+ *  Arduino's, and are lost if it is full. Bytes can also be dropped at
+ *  random, losing sync, type, data and crc bytes. Every run must end with
+ *  the last frame on the display.
+ *
+ *  Rates are on the host clock, from the first byte on the line: frames
+ *  per second from OLED_Stream::fps(), and line bytes per second, which
+ *  can not be over baud / 10. The sender's own figure is wall clock, and
+ *  a pty is not held to the baud rate, so it only means something on real
+ *  hardware. Its output is not shown.
+ *
+ *  Built and run by extras/host/run.sh, with the sender built next to it.
+ *
+ *  Dave Harris 2021
+*/
+
+#include "oled_model.h"
+#include "oled_Stream.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+
+#define RX_BUF    64                      /* Arduino serial receive buffer  */
+
+
+
+/*------------------------------- Line --------------------------------------
+ *
+ * the board's end of the serial line, on the pty master
+*/
+
+class Line : public Stream
+{
+  public:
+
+    int      fd;
+    uint64_t byteNanos;                   /* start, 8 data and stop bits    */
+    uint32_t dropOdds  = 0;               /* 1 in dropOdds bytes lost, or 0 */
+
+    long     overflows = 0;
+    long     dropped   = 0;
+    long     bytes     = 0;               /* over the wire this run         */
+    bool     heard     = false;           /* PC has written, this run       */
+    uint64_t firstAt;                     /* host nanos first byte started  */
+
+    int available()
+    {
+      _pump();
+      return _rx.size();
+    }
+
+    int read()
+    {
+      _pump();
+
+      if( _rx.empty() )
+      {
+        return -1;
+      }
+      uint8_t byt = _rx.front();
+
+      _rx.pop_front();
+      return byt;
+    }
+
+    size_t write( uint8_t byt )
+    {
+      return ::write( fd, & byt, 1 ) == 1;
+    }
+
+    bool idle()
+    {
+      _pump();
+      return _wire.empty() && _rx.empty();
+    }
+
+
+  private:
+
+    std::deque<uint8_t> _wire;            /* sent by the PC, still on wire  */
+    std::deque<uint8_t> _rx;              /* in the receive buffer          */
+    uint64_t            _wireAt = 0;      /* host nanos next byte is in     */
+    uint32_t            _rand   = 1;
+
+    void _pump();
+};
+
+
+
+/*------------------------------- Line::_pump() -----------------------------
+ *
+ * take what the PC has written, and move the bytes that have crossed the
+ * wire by now into the receive buffer
+*/
+
+void Line::_pump()
+{
+  uint8_t buf[256];
+  ssize_t n;
+
+  while( ( n = ::read( fd, buf, sizeof(buf) ) ) > 0 )
+  {
+    if( _wire.empty() && _wireAt < hostNanos )
+    {
+      _wireAt = hostNanos;                /* line was idle                  */
+    }
+    _wire.insert( _wire.end(), buf, buf + n );
+    heard = true;
+  }
+
+  while( ! _wire.empty() && _wireAt + byteNanos <= hostNanos )
+  {
+    uint8_t byt = _wire.front();
+
+    _wire.pop_front();
+
+    if( bytes++ == 0 )
+    {
+      firstAt = _wireAt;
+    }
+    _wireAt += byteNanos;
+
+    _rand = _rand * 1103515245 + 12345;
+
+    if( dropOdds && ( _rand >> 16 ) % dropOdds == 0 )
+    {
+      dropped++;
+    }
+    else if( _rx.size() >= RX_BUF )
+    {
+      overflows++;
+    }
+    else
+    {
+      _rx.push_back( byt );
+    }
+  }
+}
+
+
+
+static std::string              sender;   /* oled_stream_send path          */
+static std::string              dir;      /* frame files                    */
+static std::vector<std::string> files;
+static std::vector<uint8_t>     last;     /* last frame, what must show     */
+
+
+
+/*------------------------------- makeFrames() ------------------------------
+ *
+ * frames with a box moving across, a changing counter and some noise, so
+ * the deltas have a few spans each
+*/
+
+static void makeFrames( int count )
+{
+  char tmpl[] = "/tmp/loopbackXXXXXX";
+
+  dir = mkdtemp( tmpl );
+  srand( 1 );
+
+  for( int f = 0; f < count; f++ )
+  {
+    std::vector<uint8_t> frame( 8 * 128, 0 );
+
+    for( int col = f * 3; col < f * 3 + 20; col++ )
+    {
+      for( int page = 2; page < 5; page++ )
+      {
+        frame[ page * 128 + col ] = 0xFF;
+      }
+    }
+    for( int col = 0; col < 10; col++ )
+    {
+      frame[ 7 * 128 + col ] = rand();
+    }
+    for( int i = 0; i < 5; i++ )
+    {
+      frame[ rand() % frame.size() ] = rand();
+    }
+
+    std::string name = dir + "/f" + std::to_string( f ) + ".bin";
+    FILE *      file = fopen( name.c_str(), "wb" );
+
+    fwrite( frame.data(), 1, frame.size(), file );
+    fclose( file );
+
+    files.push_back( name );
+    last = frame;
+  }
+}
+
+
+
+/*------------------------------- realMicros() ------------------------------
+ *
+ * wall clock, for the board's waits on the PC
+*/
+
+static uint64_t realMicros()
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, & ts );
+
+  return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+
+
+/*------------------------------- run() -------------------------------------
+ *
+ * one send of all the frames through the pty, the board polling until the
+ * sender exits. True if the sender finished and the last frame shows.
+ * Until the PC writes the host clock stands still, while the sender
+ * starts, so fps() counts from then.
+*/
+
+static bool run( const char * what, long baud, uint32_t dropOdds,
+                 bool whole, Line & line, OLED_Stream & stream )
+{
+  int  slave;
+  char name[64];
+
+  if( openpty( & line.fd, & slave, name, nullptr, nullptr ) < 0 )
+  {
+    perror( "openpty" );
+    return false;
+  }
+  struct termios tio;
+
+  tcgetattr( slave, & tio );
+  cfmakeraw( & tio );
+  tcsetattr( slave, TCSANOW, & tio );
+  fcntl( line.fd, F_SETFL, O_NONBLOCK );
+
+  line.byteNanos = 10 * 1000000000ULL / baud;
+  line.dropOdds  = dropOdds;
+  line.bytes     = 0;
+  line.heard     = false;
+
+  std::string b = std::to_string( baud );
+
+  std::vector<const char *> argv = { sender.c_str(), name, b.c_str(), "64" };
+
+  if( whole )
+  {
+    argv.push_back( "-f" );
+  }
+  for( auto & f : files )
+  {
+    argv.push_back( f.c_str() );
+  }
+  argv.push_back( nullptr );
+
+  fflush( stdout );                       /* not copied into the child      */
+
+  pid_t pid = fork();
+
+  if( pid == 0 )
+  {
+    freopen( "/dev/null", "w", stdout );  /* its wall clock fps           */
+    execv( sender.c_str(), (char * const *) argv.data() );
+    _exit( 99 );
+  }
+
+  OLED_Model & m = model( OLED_I2C_ADR );
+
+  stream.begin();
+
+  int      status;
+  uint64_t limit = hostNanos + 120 * 1000000000ULL;
+
+  while( waitpid( pid, & status, WNOHANG ) == 0 && hostNanos < limit )
+  {
+    if( stream.poll() )
+    {
+      continue;
+    }
+    if( line.heard )
+    {
+      hostAdvance( 20 );                  /* loop() round                   */
+    }
+
+    if( line.idle() )                     /* wait for the PC, in real time  */
+    {
+      struct pollfd pfd   = { line.fd, POLLIN, 0 };
+      uint64_t      start = realMicros();
+
+      poll( & pfd, 1, 1 );
+
+      if( line.heard )
+      {
+        hostAdvance( realMicros() - start );
+      }
+    }
+  }
+
+  if( hostNanos >= limit )
+  {
+    kill( pid, SIGKILL );
+    waitpid( pid, & status, 0 );
+  }
+
+  while( ! line.idle() )                  /* last end of frame              */
+  {
+    stream.poll();
+    hostAdvance( 20 );
+  }
+  close( slave );
+  close( line.fd );
+
+  long rate = line.bytes * 1000000000ULL / ( hostNanos - line.firstAt );
+
+  printf( "%-13s %3u fps, %5ld line bytes/s, host clock\n", what,
+          stream.fps(), rate );
+
+  CHECK( rate <= baud / 10 );
+
+  return WIFEXITED( status ) && WEXITSTATUS( status ) == 0 &&
+         memcmp( m.ram, last.data(), last.size() ) == 0;
+}
+
+
+
+int main( int argc, char * argv[] )
+{
+  (void) argc;
+
+  sender = argv[0];
+  sender = sender.substr( 0, sender.rfind( '/' ) + 1 ) + "oled_stream_send";
+
+  makeFrames( 30 );
+
+  modelReset();
+  modelAdd( OLED_I2C_ADR );
+
+  Line        line;
+  OLED_I2C    oled;
+  OLED_Stream stream( oled );
+
+  oled.init( & line );
+
+                              /* deltas at STREAM_MAX_BAUD -----------------*/
+  CHECK( run( "deltas", STREAM_MAX_BAUD, 0, false, line, stream ) );
+  CHECK( line.overflows == 0 );
+  CHECK( stream.errors() == 0 );
+  CHECK( stream.frames() == files.size() );
+
+                              /* whole frames, each span 134 bytes ---------*/
+  oled.clearScreen();
+  CHECK( run( "whole frames", STREAM_MAX_BAUD, 0, true, line, stream ) );
+  CHECK( line.overflows == 0 );
+  CHECK( stream.errors() == 0 );
+
+                              /* bytes lost: NAKs, part packets, resyncs ---*/
+  oled.clearScreen();
+  CHECK( run( "bytes lost", STREAM_MAX_BAUD, 150, false, line, stream ) );
+  CHECK( line.dropped > 0 );
+  CHECK( stream.errors() > 0 );
+
+  printf( "board: %ld bytes dropped, %u errors\n", line.dropped,
+          stream.errors() );
+
+  for( auto & f : files )
+  {
+    unlink( f.c_str() );
+  }
+  rmdir( dir.c_str() );
+
+  return hostResult( "loopback_test" );
+}
@@ -0,0 +1,514 @@
+/* file: oled_stream_send.cpp
+*--------------------------------------------------------------------------
+*
+* host (PC) tool. Sends frames to an OLED_Stream sketch over a serial
+* port, with the credit flow control of oled_Stream.h, and reports the
+* end to end frames per second. That is wall clock, so it only means
+* something with a real board on a real UART. Over a pty to a host build
+* (loopback_test.cpp) nothing holds to the baud rate, see the rates that
+* test gives instead.
+*
+* Frame files are raw display RAM images, as for extras/anim_encode.
+* The first frame is sent whole, then only the changed spans, or every
+* frame whole with -f. A span the board NAKs is not sent again as it was,
+* as a later frame may have changed those columns since. Its columns are
+* marked stale and go in the next frame's spans, from that frame. If no
+* credit comes for a while, a span was lost unseen, so the board is asked
+* to resync, and spans it never answered are stale too.
+*
+* build:  g++ -O2 -o oled_stream_send oled_stream_send.cpp   (Linux, macOS)
+* usage:  oled_stream_send port baud height [-f] [-r repeats] frame0.bin ...
+*
+*  © Dave Harris, 2021 (Andover, UK) MERG M2740
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <poll.h>
+#include <time.h>
+#include <deque>
+#include <vector>
+
+
+static const int COLS      = 128;
+static const int MERGE_GAP = 8;     /* join spans closer than a new header  */
+
+static const uint8_t SYNC   = 0xA5; /* as oled_Stream.h                     */
+static const uint8_t SPAN   = 'S';
+static const uint8_t END    = 'E';
+static const uint8_t RESYNC = 'R';
+static const uint8_t CREDIT = 0x11;
+static const uint8_t ACK    = 0x06;
+static const uint8_t NAK    = 0x15;
+static const uint8_t SYNCED = 0x16;
+static const int     BUFS   = 2;    /* board buffers, credits at begin()    */
+static const int     WAIT_MS = 500; /* no credit this long, resync          */
+static const int     TRIES   = 4;   /* resyncs before giving up             */
+
+
+struct Span
+{
+  uint8_t page;
+  uint8_t col;
+  std::vector<uint8_t> dat;
+};
+
+
+static int               port;
+static int               credits = 0;
+static long              naks    = 0;
+static std::deque<Span>  inFlight;  /* sent, no ACK or NAK yet, in order    */
+static std::vector<bool> stale;     /* per byte, last send of it was lost   */
+
+
+
+/*------------------------------- now() --------------------------------------
+ *
+ * seconds, monotonic
+*/
+
+static double now()
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, & ts );
+
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+
+/*------------------------------- openPort() ---------------------------------
+ *
+ * open serial port raw, 8N1, at baud
+*/
+
+static bool openPort( const char * name, long baud )
+{
+  static const struct { long baud; speed_t code; } speeds[] =
+  {
+    { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 },
+    { 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 },
+#ifdef B460800
+    { 460800, B460800 },
+#endif
+#ifdef B500000
+    { 500000, B500000 },
+#endif
+#ifdef B1000000
+    { 1000000, B1000000 },
+#endif
+  };
+
+  port = open( name, O_RDWR | O_NOCTTY );
+
+  if( port < 0 )
+  {
+    return false;
+  }
+  struct termios tio;
+
+  tcgetattr( port, & tio );
+  cfmakeraw( & tio );
+
+  for( auto & s : speeds )
+  {
+    if( s.baud == baud )
+    {
+      cfsetispeed( & tio, s.code );
+      cfsetospeed( & tio, s.code );
+
+      return tcsetattr( port, TCSANOW, & tio ) == 0;
+    }
+  }
+  fprintf( stderr, "baud %ld not supported\n", baud );
+
+  return false;
+}
+
+
+
+/*------------------------------- readByte() ---------------------------------
+ *
+ * next byte from the board, -1 on timeout
+*/
+
+static int readByte( int timeoutMs )
+{
+  struct pollfd pfd = { port, POLLIN, 0 };
+  uint8_t       byt;
+
+  if( poll( & pfd, 1, timeoutMs ) > 0 && read( port, & byt, 1 ) == 1 )
+  {
+    return byt;
+  }
+  return -1;
+}
+
+
+
+/*------------------------------- markStale() --------------------------------
+ *
+ * span was lost, its bytes go again with the next frame
+*/
+
+static void markStale( const Span & span )
+{
+  for( size_t i = 0; i < span.dat.size(); i++ )
+  {
+    stale[ span.page * COLS + span.col + i ] = true;
+  }
+}
+
+
+
+/*------------------------------- answered() ---------------------------------
+ *
+ * take the span the board answered for out of inFlight, stale if lost.
+ * False if none matches, e.g. a NAK for a garbled header.
+*/
+
+static bool answered( int page, int col, int siz, bool lost )
+{
+  for( auto it = inFlight.begin(); it != inFlight.end(); ++it )
+  {
+    if( it->page == page && it->col == col &&
+        ( siz < 0 || (int) it->dat.size() == siz ) )
+    {
+      if( lost )
+      {
+        markStale( * it );
+      }
+      inFlight.erase( it );
+
+      return true;
+    }
+  }
+  return false;
+}
+
+
+
+/*------------------------------- reply() ------------------------------------
+ *
+ * handle one reply byte. Other bytes, e.g. "!I2C" messages, are skipped.
+ * Returns false on timeout.
+*/
+
+static bool reply( int timeoutMs )
+{
+  int byt = readByte( timeoutMs );
+
+  if( byt < 0 )
+  {
+    return false;
+  }
+
+  if( byt == CREDIT )                     /* from begin()                 */
+  {
+    credits++;
+  }
+  else if( byt == ACK )
+  {
+    int page = readByte( timeoutMs );
+    int col  = readByte( timeoutMs );
+    int siz  = readByte( timeoutMs );
+
+    answered( page, col, siz, false );
+    credits++;
+  }
+  else if( byt == NAK )                   /* no match, resync sorts it    */
+  {
+    int page = readByte( timeoutMs );
+    int col  = readByte( timeoutMs );
+
+    naks++;
+
+    if( answered( page, col, -1, true ) )
+    {
+      credits++;
+    }
+  }
+  else if( byt == SYNCED )                /* no reply yet, never arrived  */
+  {
+    for( auto & span : inFlight )
+    {
+      markStale( span );
+    }
+    inFlight.clear();
+    credits = BUFS;
+  }
+  return true;
+}
+
+
+
+/*------------------------------- crc8() -------------------------------------
+ *
+ * CRC-8, poly 0x07, as the board
+*/
+
+static uint8_t crc8( uint8_t crc, uint8_t byt )
+{
+  crc ^= byt;
+
+  for( int bit = 0; bit < 8; bit++ )
+  {
+    crc = crc & 0x80 ? ( crc << 1 ) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+
+
+/*------------------------------- sendPacket() -------------------------------
+ *
+ * 0xA5, bytes, crc of bytes
+*/
+
+static void sendPacket( const std::vector<uint8_t> & body )
+{
+  std::vector<uint8_t> pkt( 1, SYNC );
+  uint8_t              crc = 0;
+
+  for( uint8_t byt : body )
+  {
+    crc = crc8( crc, byt );
+    pkt.push_back( byt );
+  }
+  pkt.push_back( crc );
+
+  if( write( port, pkt.data(), pkt.size() ) != (ssize_t) pkt.size() )
+  {
+    perror( "write" );
+    exit( 1 );
+  }
+}
+
+
+
+/*------------------------------- waitCredits() ------------------------------
+ *
+ * wait until want credits are held. If none comes for a while, a span
+ * may have been lost unseen, so ask the board to resync.
+*/
+
+static void waitCredits( int want )
+{
+  int tries = 0;
+
+  while( credits < want )
+  {
+    if( reply( WAIT_MS ) )
+    {
+      tries = 0;
+    }
+    else if( ++tries > TRIES )
+    {
+      fprintf( stderr, "no credit from board\n" );
+      exit( 1 );
+    }
+    else
+    {
+      sendPacket( { RESYNC } );
+    }
+  }
+}
+
+
+
+/*------------------------------- sendSpan() ---------------------------------
+ *
+ * wait for a credit, then send span
+*/
+
+static void sendSpan( const Span & span )
+{
+  waitCredits( 1 );
+
+  credits--;
+
+  std::vector<uint8_t> body = { SPAN, span.page, span.col,
+                                (uint8_t) span.dat.size() };
+
+  body.insert( body.end(), span.dat.begin(), span.dat.end() );
+
+  sendPacket( body );
+
+  inFlight.push_back( span );
+}
+
+
+
+/*------------------------------- spans() ------------------------------------
+ *
+ * spans that change prev into next, with the stale bytes, or every page
+ * whole. Stale bytes are cleared, they are sent again.
+*/
+
+static std::vector<Span> spans( const std::vector<uint8_t> & prev,
+                                const std::vector<uint8_t> & next,
+                                int pages, bool whole )
+{
+  std::vector<Span> out;
+
+  for( int page = 0; page < pages; page++ )
+  {
+    const uint8_t * p = & prev[ page * COLS ];
+    const uint8_t * n = & next[ page * COLS ];
+
+    auto differs = [&]( int col )
+    {
+      return p[col] != n[col] || stale[ page * COLS + col ];
+    };
+
+    if( whole )
+    {
+      out.push_back( { (uint8_t) page, 0, { n, n + COLS } } );
+      continue;
+    }
+
+    for( int col = 0; col < COLS; )
+    {
+      if( ! differs( col ) )
+      {
+        col++;
+        continue;
+      }
+      int first = col;
+      int last  = col;
+
+      for( col++; col < COLS && col - last <= MERGE_GAP; col++ )
+      {
+        if( differs( col ) )
+        {
+          last = col;
+        }
+      }
+      col = last + 1;
+
+      out.push_back( { (uint8_t) page, (uint8_t) first,
+                       { n + first, n + last + 1 } } );
+    }
+  }
+  stale.assign( stale.size(), false );
+
+  return out;
+}
+
+
+
+int main( int argc, char * argv[] )
+{
+  if( argc < 5 )
+  {
+    fprintf( stderr, "usage: oled_stream_send port baud height "
+                     "[-f] [-r repeats] frame0.bin ...\n" );
+    return 1;
+  }
+  int  pages   = atoi( argv[3] ) / 8;
+  bool whole   = false;
+  int  repeats = 1;
+  int  arg     = 4;
+
+  for( ; arg < argc && argv[arg][0] == '-'; arg++ )
+  {
+    if( ! strcmp( argv[arg], "-f" ) )
+    {
+      whole = true;
+    }
+    else if( ! strcmp( argv[arg], "-r" ) && arg + 1 < argc )
+    {
+      repeats = atoi( argv[++arg] );
+    }
+  }
+
+  std::vector< std::vector<uint8_t> > frames;
+
+  for( ; arg < argc; arg++ )
+  {
+    std::vector<uint8_t> frame( pages * COLS );
+    FILE * f = fopen( argv[arg], "rb" );
+
+    if( ! f || fread( frame.data(), 1, frame.size(), f ) != frame.size() )
+    {
+      fprintf( stderr, "can not read %s\n", argv[arg] );
+      return 1;
+    }
+    fclose( f );
+    frames.push_back( frame );
+  }
+
+  if( ( pages != 4 && pages != 8 ) || frames.empty() )
+  {
+    fprintf( stderr, "height must be 32 or 64, and give frames\n" );
+    return 1;
+  }
+
+  if( ! openPort( argv[1], atol( argv[2] ) ) )
+  {
+    perror( argv[1] );
+    return 1;
+  }
+  sleep( 2 );                             /* board resets on port open    */
+
+  while( credits < BUFS && reply( 3000 ) )  /* begin() grants the buffers */
+  {
+  }
+
+  double start = now();
+  long   count = 0;
+  long   bytes = 0;
+
+  std::vector<uint8_t> prev( pages * COLS, 0 );
+  bool                 first = true;
+
+  stale.assign( pages * COLS, false );
+
+  for( int r = 0; r < repeats; r++ )
+  {
+    for( auto & frame : frames )
+    {
+      for( auto & span : spans( prev, frame, pages, whole || first ) )
+      {
+        sendSpan( span );
+        bytes += 6 + span.dat.size();
+      }
+      sendPacket( { END } );
+
+      prev  = frame;
+      first = false;
+      count++;
+    }
+  }
+
+  for( ;; )                               /* last spans shown, stale    */
+  {                                       /*   bytes of the last frame  */
+    waitCredits( BUFS );
+
+    std::vector<Span> again = spans( prev, prev, pages, false );
+
+    if( again.empty() )
+    {
+      break;
+    }
+    for( auto & span : again )
+    {
+      sendSpan( span );
+      bytes += 6 + span.dat.size();
+    }
+  }
+  double secs = now() - start;
+
+  printf( "%ld frames, %ld bytes in %.2f s: %.1f fps, %.0f bytes/s, %ld naks\n",
+          count, bytes, secs, count / secs, bytes / secs, naks );
+
+  close( port );
+
+  return 0;
+}
@@ -0,0 +1,249 @@
+/* file: oled_Anim.cpp
+*--------------------------------------------------------------------------
+*
+* delta encoded animation player for the oled_I2C library.
+*
+*  © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*/
+
+#include "oled_Anim.h"
+
+
+
+/*------------------------------- OLED_Anim::play() -------------------------
+ *
+ * play a PROGMEM delta animation, see oled_Anim.h for the format
+*/
+
+void OLED_Anim::play( const uint8_t * prog_anim, uint8_t fps, bool loop )
+{
+  _anim    = prog_anim;
+  _next    = prog_anim;
+  _gen     = nullptr;
+  _loop    = loop;
+  _wrapped = false;
+  _clear   = false;
+
+  uint8_t page;                   /* find the 2nd frame, where loops go on */
+
+  for( _second = prog_anim; ( page = pgm_read_byte( _second ) ) < ANIM_LOOP; )
+  {
+    _second += 3 + pgm_read_byte( _second + 2 );
+  }
+  if( page == ANIM_FRAME_END )
+  {
+    _second++;
+  }
+
+  _start( fps );
+}
+
+
+
+/*------------------------------- OLED_Anim::play() -------------------------
+ *
+ * play frames generated by gen(). frames 0 plays until stop()
+*/
+
+void OLED_Anim::play( OLED_AnimGen gen, uint16_t frames, uint8_t fps )
+{
+  _anim  = nullptr;
+  _gen   = gen;
+  _count = frames;
+
+  _start( fps );
+}
+
+
+
+/*------------------------------- OLED_Anim::_start() -----------------------
+ *
+ * reset frame count, stats and timing. First frame is due now.
+*/
+
+void OLED_Anim::_start( uint8_t fps )
+{
+  _frame   = 0;
+  _shown   = 0;
+  _dropped = 0;
+  _period  = 1000000UL / ( fps ? fps : 1 );
+  _due     = micros();
+  _begin   = millis();
+  _playing = true;
+}
+
+
+
+/*------------------------------- OLED_Anim::stop() -------------------------
+ *
+ * stop playing. Stats stay readable.
+*/
+
+void OLED_Anim::stop()
+{
+  _playing = false;
+}
+
+
+
+/*------------------------------- OLED_Anim::tick() -------------------------
+ *
+ * send the next frame if it is due. Call often, e.g. every loop().
+ * If the frame is late by whole periods, those slots are counted as
+ * dropped. Deltas can not be skipped, so the frame is still sent.
+*/
+
+bool OLED_Anim::tick()
+{
+  if( ! _playing )
+  {
+    return false;
+  }
+
+  uint32_t late = micros() - _due;
+
+  if( (int32_t) late < 0 )  /* not due yet */
+  {
+    return true;
+  }
+
+  uint32_t missed = late / _period;
+
+  _dropped += missed;
+  _due     += _period * ( missed + 1 );
+
+  if( _gen )
+  {
+    _frameGen();
+  }
+  else
+  {
+    _frameProg();
+  }
+
+  return _playing;
+}
+
+
+
+/*------------------------------- OLED_Anim::fps() --------------------------
+ *
+ * achieved frames per second since play()
+*/
+
+uint16_t OLED_Anim::fps()
+{
+  uint32_t ms = millis() - _begin;
+
+  return ms ? (uint32_t) _shown * 1000UL / ms : 0;
+}
+
+
+
+/*---------------------------- OLED_Anim::_frameProg() ----------------------
+ *
+ * send the spans of the next PROGMEM frame
+*/
+
+void OLED_Anim::_frameProg()
+{
+  if( _clear )                  /* no wrap frame, clear in a slot of its own */
+  {
+    _oled.clearScreen();
+    _clear = false;
+    return;
+  }
+
+  uint8_t buf[ OLED_PX_HOR ];
+  uint8_t page;
+
+  while( ( page = pgm_read_byte( _next ) ) < ANIM_LOOP )
+  {
+    uint8_t colPx = pgm_read_byte( _next + 1 );
+    uint8_t siz   = pgm_read_byte( _next + 2 );
+
+    memcpy_P( buf, _next + 3, siz );
+
+    _oled.putSpan( page, colPx, buf, siz );
+
+    _next += 3 + siz;
+  }
+
+  if( page == ANIM_FRAME_END )
+  {
+    _next++;
+    _frame++;
+    _shown++;
+  }
+
+  _nextFrame();
+}
+
+
+
+/*---------------------------- OLED_Anim::_nextFrame() ----------------------
+ *
+ * after a frame, step over the loop marks so _next is the next frame.
+ * The last frame stays on screen for its whole slot: the wrap frame, or
+ * the clear of an array without one, goes in the next slot.
+*/
+
+void OLED_Anim::_nextFrame()
+{
+  uint8_t mark = pgm_read_byte( _next );
+
+  if( mark == ANIM_LOOP && _loop )
+  {
+    _next++;                    /* wrap frame, last back to the first      */
+    _wrapped = true;
+  }
+  else if( mark == ANIM_END && _loop && _wrapped )
+  {
+    _next    = _second;         /* first frame is showing, go on from 2nd  */
+    _wrapped = false;
+
+    if( pgm_read_byte( _next ) == ANIM_LOOP )  /* 1 frame animation       */
+    {
+      _next++;
+      _wrapped = true;
+    }
+  }
+  else if( mark == ANIM_END && _loop )
+  {
+    _next  = _anim;             /* first frame is from clear, so clear     */
+    _clear = true;
+  }
+  else if( mark == ANIM_LOOP || mark == ANIM_END )
+  {
+    _playing = false;
+  }
+}
+
+
+
+/*---------------------------- OLED_Anim::_frameGen() -----------------------
+ *
+ * send the spans of the next generated frame
+*/
+
+void OLED_Anim::_frameGen()
+{
+  OLED_Span span;
+
+  for( uint8_t spanNo = 0; _gen( _frame, spanNo, span ); spanNo++ )
+  {
+    _oled.putSpan( span.page, span.colPx, span.dat, span.siz );
+  }
+
+  _frame++;
+  _shown++;
+
+  if( _count && _frame >= _count )
+  {
+    _playing = false;
+  }
+}
+
+
+/*----------------------------- eof oled_Anim.cpp ---------------------------*/
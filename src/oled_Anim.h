@@ -0,0 +1,127 @@
+/* file oled_Anim.h
+*---------------------------------------------------------------------------
+*
+* delta encoded animation player for the oled_I2C library.
+*
+* Each frame is a list of spans, the bytes that changed since the previous
+* frame. A span is written with OLED_I2C::putSpan(), so only the changed
+* columns of the changed pages go on the I2C bus.
+*
+*         © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*-------------------------------PROGMEM format-------------------------------
+*
+*   animation:  frame ... frame, ANIM_LOOP, wrap frame, ANIM_END
+*   frame:      span ... span, ANIM_FRAME_END
+*   span:       page (0 to 7), column (0 to 127), n (1 to 128), n bytes
+*
+* The first frame is the change from a cleared screen. The wrap frame is
+* the change from the last frame back to the first. Looping plays it, then
+* goes on from the second frame, so the screen is never cleared. Without
+* loop, play stops at ANIM_LOOP.
+* extras/anim_encode makes the PROGMEM array from raw frame files.
+*
+* An array with no wrap frame (ANIM_END straight after the last frame)
+* still loops, with a clearScreen() in a frame slot of its own.
+*
+*-------------------------------Example usage---------------------------------
+*
+* OLED_I2C  oled;
+* OLED_Anim anim( oled );
+*
+* setup():  oled.init( & Serial );
+*           oled.clearScreen();
+*           anim.play( gauge, 25, true );   // PROGMEM array, 25 fps, loop
+*
+* loop():   anim.tick();
+*
+*------------------------------------------------------------------------------
+*/
+#ifndef _oled_Anim_H_
+#define _oled_Anim_H_
+
+
+#include "oled_I2C.h"
+
+
+#define ANIM_FRAME_END  0xFF                  /* PROGMEM end of frame mark  */
+#define ANIM_END        0xFE                  /* PROGMEM end of animation   */
+#define ANIM_LOOP       0xFD                  /* PROGMEM wrap frame follows */
+
+
+
+struct OLED_Span                              /* one changed span           */
+{
+  uint8_t   page;                             /* 0 to 7                     */
+  uint8_t   colPx;                            /* 0 to 127                   */
+  uint8_t   siz;                              /* 1 to 128                   */
+  uint8_t * dat;                              /* RAM bytes                  */
+};
+
+
+/* generated frames. Called for span# 0, 1, 2... of frame# until it returns
+   false, so fill span and return true for each span of the frame          */
+
+typedef bool ( * OLED_AnimGen )( uint16_t frame, uint8_t spanNo, OLED_Span & span );
+
+
+
+class OLED_Anim
+{
+  public:
+
+    OLED_Anim( OLED_I2C & oled ) : _oled( oled ) {}
+
+                              /* play PROGMEM animation at fps              */
+
+    void play( const uint8_t * prog_anim, uint8_t fps, bool loop = false );
+
+                              /* play frames from gen(), 0 frames = forever */
+
+    void play( OLED_AnimGen gen, uint16_t frames, uint8_t fps );
+
+    bool tick();              /* call often. false when not playing         */
+
+    void stop();              /* stop playing, screen keeps last frame      */
+
+    uint16_t frames()  { return _shown; }       /* frames shown             */
+
+    uint16_t dropped() { return _dropped; }     /* frame slots missed       */
+
+    uint16_t fps();                             /* achieved frames/second   */
+
+
+  private:
+
+    OLED_I2C & _oled;
+
+    void _start( uint8_t fps );                 /* reset stats and timing   */
+
+    void _frameProg();                          /* send next PROGMEM frame  */
+    void _frameGen();                           /* send next generated frame*/
+
+    void _nextFrame();                          /* after a frame: loop/end  */
+
+    const uint8_t * _anim = nullptr;            /* PROGMEM animation start  */
+    const uint8_t * _next = nullptr;            /* PROGMEM next frame       */
+    const uint8_t * _second;                    /* PROGMEM 2nd frame, loops */
+    OLED_AnimGen    _gen  = nullptr;            /* frame generator          */
+
+    uint16_t _frame   = 0;                      /* next frame#              */
+    uint16_t _count   = 0;                      /* gen frames, 0 = forever  */
+    uint16_t _shown   = 0;
+    uint16_t _dropped = 0;
+
+    uint32_t _period;                           /* micros per frame         */
+    uint32_t _due;                              /* micros next frame due    */
+    uint32_t _begin;                            /* millis play started      */
+
+    bool _loop    = false;
+    bool _wrapped = false;                      /* wrap frame is next/shown */
+    bool _clear   = false;                      /* clear, no wrap frame     */
+    bool _playing = false;
+
+}; /* end of class OLED_Anim */
+
+
+#endif /* _oled_Anim_H_ */
@@ -0,0 +1,390 @@
+/* file: oled_Bus.cpp
+*--------------------------------------------------------------------------
+*
+* shares one I2C bus fairly between several OLED_I2C displays.
+*
+*  © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*/
+
+#include "oled_Bus.h"
+
+
+/* queue record header byte. Commands are never split, data can be split
+   anywhere as the display column pointer carries on from where it was    */
+
+#define REC_DAT   0x80        /* data record, else command record          */
+#define REC_CO    0x40        /* command record sent Co=1 before its data  */
+#define LEN_DAT   0x7F        /* data bytes that follow, 1 to 127          */
+#define LEN_CMD   0x3F        /* command bytes that follow, 1 to 63        */
+
+#define NONE      0xFF        /* no open data record                       */
+
+
+
+/*------------------------------- OLED_Bus::add() ---------------------------
+ *
+ * add display to the bus. From now on its writes are queued.
+*/
+
+int8_t OLED_Bus::add( OLED_I2C & oled, uint8_t priority,
+                      uint8_t muxAdr, uint8_t muxChan )
+{
+  if( _count >= OLED_BUS_DISPLAYS )
+  {
+    return -1;
+  }
+  _Slot & s = _slots[_count];
+
+  s.oled     = & oled;
+  s.priority = priority;
+  s.muxAdr   = muxAdr;
+  s.muxChan  = muxChan;
+  s.tail     = 0;
+  s.ready    = 0;
+  s.used     = 0;
+  s.datHdr   = NONE;
+  s.stats    = {};
+
+  oled._bus  = this;
+  oled._slot = _count;
+
+  return _count++;
+}
+
+
+
+/*------------------------------- OLED_Bus::poll() --------------------------
+ *
+ * pick the next display with work and send one transaction of it,
+ * at most _chunk data bytes. Call often, e.g. every loop().
+*/
+
+bool OLED_Bus::poll()
+{
+  int8_t pick = -1;
+
+  for( uint8_t i = 1; i <= _count; i++ )  /* start after the latest turn */
+  {
+    uint8_t n = ( _turn + i ) % _count;
+
+    if( _slots[n].ready && ( pick < 0 || ( _sched == PRIORITY &&
+        _slots[n].priority > _slots[pick].priority ) ) )
+    {
+      pick = n;
+    }
+  }
+
+  if( pick < 0 )
+  {
+    return false;
+  }
+  _turn = pick;
+
+  _send( _slots[pick] );
+
+  return true;
+}
+
+
+
+/*------------------------------- OLED_Bus::flush() -------------------------
+ *
+ * send everything queued, still taking turns
+*/
+
+void OLED_Bus::flush()
+{
+  while( poll() )
+  {
+  }
+}
+
+
+
+/*------------------------------- OLED_Bus::_cmds() -------------------------
+ *
+ * queue held commands then cmd[] as command only records
+*/
+
+void OLED_Bus::_cmds( uint8_t slot, const uint8_t held[], uint8_t heldN,
+                      const uint8_t cmd[], uint8_t siz )
+{
+  _Slot & s = _slots[slot];
+
+  uint8_t all = heldN + siz;
+
+  for( uint8_t i = 0; i < all; )
+  {
+    uint8_t n = all - i;
+
+    if( n > LEN_CMD )
+    {
+      n = LEN_CMD;
+    }
+    if( n > OLED_BUS_QUEUE / 2 )
+    {
+      n = OLED_BUS_QUEUE / 2;
+    }
+    _room( s, n + 1 );
+
+    _write( s, n );
+
+    for( uint8_t end = i + n; i < end; i++ )
+    {
+      _write( s, i < heldN ? held[i] : cmd[i - heldN] );
+    }
+    _commit( s );
+  }
+}
+
+
+
+/*------------------------------- OLED_Bus::_begin() ------------------------
+ *
+ * queue held commands to go Co=1 before the data, and open a data record.
+ * Room is kept for one data byte, so the commands never go without data.
+*/
+
+void OLED_Bus::_begin( uint8_t slot, const uint8_t held[], uint8_t heldN )
+{
+  _Slot & s = _slots[slot];
+
+  _room( s, heldN + 3 );
+
+  if( heldN )
+  {
+    _write( s, REC_CO | heldN );
+
+    for( uint8_t i = 0; i < heldN; i++ )
+    {
+      _write( s, held[i] );
+    }
+  }
+  s.datHdr = ( s.tail + s.used ) % OLED_BUS_QUEUE;
+
+  _write( s, REC_DAT );
+}
+
+
+
+/*------------------------------- OLED_Bus::_put() --------------------------
+ *
+ * queue a data byte. If the queue or record is full, what is queued so
+ * far is made ready and the bus polled for room.
+*/
+
+void OLED_Bus::_put( uint8_t slot, uint8_t byt )
+{
+  _Slot & s = _slots[slot];
+
+  if( s.datHdr == NONE || s.used == OLED_BUS_QUEUE ||
+      ( s.q[s.datHdr] & LEN_DAT ) == LEN_DAT )
+  {
+    _commit( s );
+    _room( s, 2 );
+
+    s.datHdr = ( s.tail + s.used ) % OLED_BUS_QUEUE;
+
+    _write( s, REC_DAT );
+  }
+  _write( s, byt );
+
+  s.q[s.datHdr]++;
+}
+
+
+
+/*------------------------------- OLED_Bus::_end() --------------------------
+ *
+ * end of display transaction, all its records are ready to send
+*/
+
+void OLED_Bus::_end( uint8_t slot )
+{
+  _commit( _slots[slot] );
+}
+
+
+
+/*------------------------------- OLED_Bus::_room() -------------------------
+ *
+ * poll the bus until the queue has room for need bytes
+*/
+
+void OLED_Bus::_room( _Slot & s, uint8_t need )
+{
+  while( OLED_BUS_QUEUE - s.used < need && s.ready )
+  {
+    poll();
+  }
+}
+
+
+
+/*------------------------------- OLED_Bus::_write() ------------------------
+ *
+ * add byte to queue, not yet ready to send
+*/
+
+void OLED_Bus::_write( _Slot & s, uint8_t byt )
+{
+  s.q[ ( s.tail + s.used ) % OLED_BUS_QUEUE ] = byt;
+
+  s.used++;
+}
+
+
+
+/*------------------------------- OLED_Bus::_commit() -----------------------
+ *
+ * close the open data record and make all queued bytes ready to send
+*/
+
+void OLED_Bus::_commit( _Slot & s )
+{
+  if( s.datHdr != NONE && ( s.q[s.datHdr] & LEN_DAT ) == 0 )
+  {
+    s.used--;                  /* drop empty data record */
+  }
+  s.datHdr = NONE;
+
+  if( s.ready == 0 && s.used )
+  {
+    s.since = micros();        /* latency from queue not empty */
+  }
+  s.ready = s.used;
+}
+
+
+
+/*------------------------------- OLED_Bus::_at() ---------------------------
+ *
+ * queue byte i after tail
+*/
+
+uint8_t & OLED_Bus::_at( _Slot & s, uint8_t i )
+{
+  return s.q[ ( s.tail + i ) % OLED_BUS_QUEUE ];
+}
+
+
+
+/*------------------------------- OLED_Bus::_pop() --------------------------
+ *
+ * drop n sent bytes from the queue
+*/
+
+void OLED_Bus::_pop( _Slot & s, uint8_t n )
+{
+  s.tail   = ( s.tail + n ) % OLED_BUS_QUEUE;
+  s.ready -= n;
+  s.used  -= n;
+}
+
+
+
+/*------------------------------- OLED_Bus::_send() -------------------------
+ *
+ * send one transaction from the display queue:
+ *   command records, merged up to _chunk bytes, or
+ *   Co=1 command record then up to _chunk bytes of its data, or
+ *   up to _chunk bytes of data
+*/
+
+void OLED_Bus::_send( _Slot & s )
+{
+  if( s.muxAdr ? s.muxAdr != _muxAdr || s.muxChan != _muxChan
+               : _muxAdr != 0 )
+  {                                   /* switch mux, or all channels off   */
+    uint8_t muxAdr = s.muxAdr ? s.muxAdr : _muxAdr;
+
+    I2C_START( muxAdr << 1 );
+    I2C_BYTE( s.muxAdr ? 1 << s.muxChan : 0 );
+    I2C_STOP();
+
+    _muxAdr  = s.muxAdr;
+    _muxChan = s.muxChan;
+  }
+
+  uint8_t hdr = _at( s, 0 );
+  uint8_t n   = hdr & LEN_CMD;
+
+  bool withDat = ( hdr & REC_CO ) && ! ( hdr & REC_DAT ) &&
+                 s.ready > n + 1 && ( _at( s, n + 1 ) & REC_DAT );
+
+  I2C_START( s.oled->_adr << 1 );
+
+  if( ! ( hdr & REC_DAT ) && ! withDat )       /* command only            */
+  {
+    I2C_BYTE( OLED_I2C::DISPLAY_COMMAND );
+
+    uint8_t sent = 0;
+    do
+    {
+      for( uint8_t i = 1; i <= n; i++ )
+      {
+        I2C_BYTE( _at( s, i ) );
+      }
+      _pop( s, n + 1 );
+
+      sent += n;
+      hdr   = _at( s, 0 );
+      n     = hdr & LEN_CMD;
+    }
+    while( s.ready && ! ( hdr & ( REC_DAT | REC_CO ) ) && sent + n <= _chunk );
+  }
+  else
+  {
+    if( withDat )                              /* window, Co=1 each       */
+    {
+      for( uint8_t i = 1; i <= n; i++ )
+      {
+        I2C_BYTE( OLED_I2C::DISPLAY_CO_COMMAND );
+        I2C_BYTE( _at( s, i ) );
+      }
+      _pop( s, n + 1 );
+
+      hdr = _at( s, 0 );
+    }
+    I2C_BYTE( OLED_I2C::DISPLAY_DATA );
+
+    n = hdr & LEN_DAT;
+    uint8_t take = n < _chunk ? n : _chunk;
+
+    for( uint8_t i = 1; i <= take; i++ )
+    {
+      I2C_BYTE( _at( s, i ) );
+    }
+
+    if( take < n )                             /* rest stays queued       */
+    {
+      _pop( s, take );
+      _at( s, 0 ) = REC_DAT | ( n - take );
+    }
+    else
+    {
+      _pop( s, n + 1 );
+    }
+  }
+  I2C_STOP();
+
+  s.oled->_report_if_I2C_error();
+
+  if( s.ready == 0 )                           /* all sent, note latency  */
+  {
+    uint32_t lat = micros() - s.since;
+
+    s.stats.last = lat;
+    s.stats.avg  = s.stats.count ? s.stats.avg - s.stats.avg / 8 + lat / 8
+                                 : lat;
+    if( lat > s.stats.max )
+    {
+      s.stats.max = lat;
+    }
+    s.stats.count++;
+  }
+}
+
+
+/*----------------------------- eof oled_Bus.cpp ----------------------------*/
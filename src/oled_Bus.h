@@ -0,0 +1,129 @@
+/* file oled_Bus.h
+*---------------------------------------------------------------------------
+*
+* shares one I2C bus fairly between several OLED_I2C displays.
+*
+* Once added, a display does not write the bus itself. Its transactions are
+* queued, and poll() sends them a chunk at a time, taking turns between the
+* displays. A big redraw on one display no longer holds up the others.
+* When a display queue is full, the display calls poll() until there is
+* room, so the other displays keep getting their turns.
+*
+* Displays behind a TCA9548A style mux give its address and channel to
+* add(). The channel is only switched when it changes, and switched off
+* for displays not on the mux, in case one has the same address.
+*
+*         © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*-------------------------------Example usage---------------------------------
+*
+* OLED_I2C  oledA( 0x3C );
+* OLED_I2C  oledB( 0x3D );
+* OLED_Bus  bus;
+*
+* setup():  bus.add( oledA );
+*           bus.add( oledB, 1 );          // priority 1, only if PRIORITY
+*           oledA.init( & Serial );
+*           oledB.init( & Serial );
+*
+* loop():   bus.poll();                   // or bus.flush() to send all
+*
+*------------------------------------------------------------------------------
+*/
+#ifndef _oled_Bus_H_
+#define _oled_Bus_H_
+
+
+#include "oled_I2C.h"
+
+
+#define OLED_BUS_DISPLAYS  3          /* max displays on one bus            */
+#define OLED_BUS_QUEUE    64          /* queue bytes per display, max 255   */
+
+
+
+struct OLED_BusStats                  /* queue to sent latency, micros      */
+{
+  uint32_t last;                      /* latest                             */
+  uint32_t max;                       /* worst                              */
+  uint32_t avg;                       /* moving average, 1/8 weight         */
+  uint16_t count;                     /* times the queue was emptied        */
+};
+
+
+
+class OLED_Bus
+{
+  friend class OLED_I2C;
+
+  public:
+
+    enum SCHED_t : uint8_t
+    {
+      ROUND_ROBIN,                    /* every display with work in turn    */
+      PRIORITY                        /* highest priority first, then turns */
+    };
+
+                              /* chunk: data bytes per turn, 0 taken as 1   */
+
+    OLED_Bus( uint8_t chunk = 32, SCHED_t sched = ROUND_ROBIN )
+      : _chunk( chunk ? chunk : 1 ), _sched( sched ) {}
+
+                              /* add display. Returns slot#, -1 if bus full */
+
+    int8_t add( OLED_I2C & oled, uint8_t priority = 0,
+                uint8_t muxAdr = 0, uint8_t muxChan = 0 );
+
+    bool poll();              /* send one chunk. false if nothing to send   */
+
+    void flush();             /* send everything queued                     */
+
+    const OLED_BusStats & stats( uint8_t slot ) { return _slots[slot].stats; }
+
+
+  private:
+
+    struct _Slot
+    {
+      OLED_I2C * oled;
+      uint8_t    priority;
+      uint8_t    muxAdr;              /* 0 = no mux                         */
+      uint8_t    muxChan;
+      uint8_t    q[ OLED_BUS_QUEUE ]; /* records: header byte, then bytes   */
+      uint8_t    tail;                /* next byte to send                  */
+      uint8_t    ready;               /* bytes ready to send from tail      */
+      uint8_t    used;                /* ready + bytes still being queued   */
+      uint8_t    datHdr;              /* open data record header, or NONE   */
+      uint32_t   since;               /* micros queue went from empty       */
+      OLED_BusStats stats;
+    };
+
+    _Slot   _slots[ OLED_BUS_DISPLAYS ];
+    uint8_t _count = 0;
+    uint8_t _turn  = 0;               /* slot that had the latest turn      */
+    uint8_t _chunk;                   /* max data bytes per transaction     */
+    SCHED_t _sched;
+
+    uint8_t _muxAdr  = 0;             /* mux now switched on, 0 = none      */
+    uint8_t _muxChan = 0;
+
+                              /* called from OLED_I2C transmit functions    */
+
+    void _cmds( uint8_t slot, const uint8_t held[], uint8_t heldN,
+                const uint8_t cmd[], uint8_t siz );
+    void _begin( uint8_t slot, const uint8_t held[], uint8_t heldN );
+    void _put( uint8_t slot, uint8_t byt );
+    void _end( uint8_t slot );
+
+    void _room( _Slot & s, uint8_t need );         /* poll until room      */
+    void _write( _Slot & s, uint8_t byt );         /* add byte to queue    */
+    void _commit( _Slot & s );                     /* make queued ready    */
+    uint8_t & _at( _Slot & s, uint8_t i );         /* byte i after tail    */
+    void _pop( _Slot & s, uint8_t n );             /* drop n sent bytes    */
+
+    void _send( _Slot & s );                       /* send one transaction */
+
+}; /* end of class OLED_Bus */
+
+
+#endif /* _oled_Bus_H_ */
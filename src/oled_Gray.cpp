@@ -0,0 +1,190 @@
+/* file: oled_Gray.cpp
+*--------------------------------------------------------------------------
+*
+* 4 level grayscale for the oled_I2C library, by switching bitplanes.
+*
+*  © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*/
+
+#include "oled_Gray.h"
+
+
+#define PAGES  ( OLED_PX_VERT / 8 )
+#define NONE   0xFF                   /* page has no differing columns     */
+
+
+
+/*------------------------------- OLED_Gray::show() -------------------------
+ *
+ * find the columns where the planes differ, work out the refresh rate
+ * the bus allows, then show the msb plane and start switching
+*/
+
+bool OLED_Gray::show( const uint8_t * prog_msb, const uint8_t * prog_lsb, uint8_t hz )
+{
+  _msb   = prog_msb;
+  _lsb   = prog_lsb;
+  _minHz = hz ? hz : 1;
+
+  uint32_t bytes = 0;                 /* bus bytes per plane switch        */
+
+  for( uint8_t page = 0; page < PAGES; page++ )
+  {
+    _first[page] = NONE;
+
+    for( uint8_t col = 0; col < OLED_PX_HOR; col++ )
+    {
+      uint16_t i = page * OLED_PX_HOR + col;
+
+      if( pgm_read_byte( _msb + i ) != pgm_read_byte( _lsb + i ) )
+      {
+        if( _first[page] == NONE )
+        {
+          _first[page] = col;
+        }
+        _last[page] = col;
+      }
+    }
+
+    if( _first[page] != NONE )      /* adr, 4 Co window cmds, ctrl, data */
+    {
+      bytes += 1 + 8 + 1 + _last[page] - _first[page] + 1;
+    }
+  }
+                                    /* a switch must fit in its step, 1/3  */
+                                    /*   of a refresh. 9 clocks a byte     */
+  uint32_t maxHz = bytes ? OLED_I2C_HZ / ( 3 * 9 * bytes ) : 0;
+
+  _maxHz = maxHz < 0xFFFF ? maxHz : 0xFFFF;
+
+  _plane( _msb, true );             /* whole msb plane to start            */
+
+  _gray = bytes && _maxHz >= _minHz;
+
+  _period = 1000000UL / ( 3UL * _minHz );
+  _step   = 1;                      /* msb is showing, 2nd msb step next   */
+  _cycles = 0;
+  _hz     = 0;
+  _since  = micros();
+  _due    = _since + _period;
+
+  return _gray;
+}
+
+
+
+/*------------------------------- OLED_Gray::tick() -------------------------
+ *
+ * switch the plane if the step is due. Call often, e.g. every loop().
+ * Steps are timed with micros(). I2C is not sent from a timer interrupt,
+ * as it would hold interrupts off for the whole plane switch.
+ * Once a second the refresh rate is measured. 10% below hz, fall back.
+*/
+
+bool OLED_Gray::tick()
+{
+  if( ! _gray )
+  {
+    return false;
+  }
+
+  uint32_t now = micros();
+
+  if( (int32_t) ( now - _due ) < 0 )  /* not due yet */
+  {
+    return true;
+  }
+
+  _due += _period;
+
+  if( (int32_t) ( now - _due ) >= 0 ) /* a step behind, catch up from now */
+  {
+    _due = now + _period;
+  }
+
+  _step = ( _step + 1 ) % 3;
+
+  if( _step == 0 )
+  {
+    _plane( _msb, false );
+    _cycles++;
+  }
+  else if( _step == 2 )
+  {
+    _plane( _lsb, false );
+  }
+
+  uint32_t elapsed = now - _since;
+
+  if( elapsed >= 1000000UL )
+  {
+    _hz     = (uint32_t) _cycles * 1000000UL / elapsed;
+    _cycles = 0;
+    _since  = now;
+
+    if( _hz * 10UL < _minHz * 9UL )   /* 10% below, not timing jitter */
+    {
+      _fallback();
+    }
+  }
+  return _gray;
+}
+
+
+
+/*------------------------------- OLED_Gray::stop() -------------------------
+ *
+ * stop switching, leave the msb plane showing
+*/
+
+void OLED_Gray::stop()
+{
+  _fallback();
+}
+
+
+
+/*------------------------------- OLED_Gray::_fallback() --------------------
+ *
+ * 1 bit output, msb plane only
+*/
+
+void OLED_Gray::_fallback()
+{
+  if( _gray && _step == 2 )         /* lsb is showing */
+  {
+    _plane( _msb, false );
+  }
+  _gray = false;
+}
+
+
+
+/*------------------------------- OLED_Gray::_plane() -----------------------
+ *
+ * send the differing columns of each page of a plane, or all of it
+*/
+
+void OLED_Gray::_plane( const uint8_t * prog_plane, bool all )
+{
+  uint8_t buf[ OLED_PX_HOR ];
+
+  for( uint8_t page = 0; page < PAGES; page++ )
+  {
+    uint8_t first = all ? 0 : _first[page];
+    uint8_t last  = all ? OLED_PX_HOR - 1 : _last[page];
+
+    if( first != NONE )
+    {
+      uint8_t siz = last - first + 1;
+
+      memcpy_P( buf, prog_plane + page * OLED_PX_HOR + first, siz );
+
+      _oled.putSpan( page, first, buf, siz );
+    }
+  }
+}
+
+
+/*----------------------------- eof oled_Gray.cpp ---------------------------*/
@@ -0,0 +1,91 @@
+/* file oled_Gray.h
+*---------------------------------------------------------------------------
+*
+* 4 level grayscale for the oled_I2C library, by switching bitplanes.
+*
+* The image is two PROGMEM bitplanes, in display RAM format (page by page,
+* 128 bytes each, bit 0 at top). Pixel level = 2 x msb + lsb. Each refresh
+* is 3 steps: msb, msb, lsb, so a pixel is lit 0, 1/3, 2/3 or all the time.
+* Only the columns where the planes differ are sent at each switch.
+*
+* RAM is too small for the planes, so they are in PROGMEM. 1 KB each for
+* 128x64, 512 bytes for 128x32.
+*
+* If the bus can not switch the planes at the refresh rate asked for, or
+* the rate measured falls below it, the msb plane is shown alone (1 bit).
+*
+*         © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*-------------------------------Example usage---------------------------------
+*
+* OLED_I2C  oled;
+* OLED_Gray gray( oled );
+*
+* setup():  oled.init( & Serial );
+*           gray.show( iconMsb, iconLsb, 50 );   // 50 refreshes/second
+*
+* loop():   gray.tick();                         // call often
+*
+*------------------------------------------------------------------------------
+*/
+#ifndef _oled_Gray_H_
+#define _oled_Gray_H_
+
+
+#include "oled_I2C.h"
+
+
+
+class OLED_Gray
+{
+  public:
+
+    OLED_Gray( OLED_I2C & oled ) : _oled( oled ) {}
+
+                              /* show planes at hz refreshes/second.        */
+                              /*   false if it fell back to 1 bit           */
+
+    bool show( const uint8_t * prog_msb, const uint8_t * prog_lsb, uint8_t hz = 50 );
+
+    bool tick();              /* call often. false when not in grayscale    */
+
+    void stop();              /* stop, leaves msb plane showing             */
+
+    bool gray() { return _gray; }             /* still in grayscale         */
+
+    uint16_t maxHz() { return _maxHz; }       /* bus limit, from show(). 0  */
+                                              /*   if the planes are same   */
+
+    uint16_t hz() { return _hz; }             /* measured refreshes/second  */
+
+
+  private:
+
+    OLED_I2C & _oled;
+
+    void _plane( const uint8_t * prog_plane, bool all ); /* send plane      */
+
+    void _fallback();                         /* msb plane only             */
+
+    const uint8_t * _msb;
+    const uint8_t * _lsb;
+
+    uint8_t  _first[ OLED_PX_VERT / 8 ];      /* per page, first and last   */
+    uint8_t  _last[ OLED_PX_VERT / 8 ];       /*   differing col, or none   */
+
+    uint8_t  _minHz;
+    uint8_t  _step;                           /* 0, 1 msb; 2 lsb            */
+    uint16_t _maxHz;
+    uint16_t _hz      = 0;
+    uint16_t _cycles;                         /* refreshes this second      */
+
+    uint32_t _period;                         /* micros per step            */
+    uint32_t _due;                            /* micros next step due       */
+    uint32_t _since;                          /* micros counting began      */
+
+    bool _gray = false;
+
+}; /* end of class OLED_Gray */
+
+
+#endif /* _oled_Gray_H_ */
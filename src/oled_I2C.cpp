@@ -16,6 +16,7 @@
 */
 
 #include "oled_I2C.h"
+#include "oled_Bus.h"
 
 
 
@@ -71,54 +72,162 @@ void OLED_I2C::_report_if_I2C_error()
     _serialRef->println("!I2C ");
     
     I2C_ErrorFlag = 0;
+
+#if defined OLED_SOFT_I2C
+    _serialRef->println( SI2C_NAckMask, BIN );    /* lanes that did not ACK */
+    
+    SI2C_NAckMask = 0;
+#endif
+  }
+}
+
+
+/*------------------------------ OLED_I2C::_queueCmd() ----------------------
+ *
+ * hold commands to go out at the start of the next transaction
+*/
+
+void OLED_I2C::_queueCmd( const uint8_t cmd[], uint8_t siz )
+{
+  if( _cmdN + siz > sizeof(_cmdQ) )  /* no room? send held commands now */
+  {
+    _txCmd( nullptr, 0 );
   }
+  memcpy( & _cmdQ[_cmdN], cmd, siz );
+  
+  _cmdN += siz;
 }
 
 
+
 /*------------------------------ OLED_I2C::_txCmd() --------------------------
  *
- * send command byte array to OLED on I2C
+ * send held commands then command byte array to OLED on I2C
 */
 
 void OLED_I2C::_txCmd( uint8_t cmd[], uint8_t siz ) 
 {
-  i2c_start( OLED_I2C_ADR << 1 );
+  if( _bus )                    /* queue for the bus scheduler instead     */
+  {
+    _bus->_cmds( _slot, _cmdQ, _cmdN, cmd, siz );
+    _cmdN = 0;
+    return;
+  }
+  
+  I2C_START( _adr << 1 );
   
-  i2c_byte( DISPLAY_COMMAND );
+  I2C_BYTE( DISPLAY_COMMAND );  /* Co=0: all following bytes are commands */
+  
+  for( uint8_t byt = 0; byt < _cmdN; byt++ ) 
+  {
+    I2C_BYTE( _cmdQ[byt] );
+  }
+  _cmdN = 0;
   
   for( uint8_t byt = 0; byt < siz; byt++ ) 
   {
-    i2c_byte( cmd[byt] );
+    I2C_BYTE( cmd[byt] );
   }
-  i2c_stop();
+  I2C_STOP();
   
   _report_if_I2C_error();
 }
 
 
 
-/*--------------------------- OLED_I2C::_txDat() ----------------------------
+/*------------------------------ OLED_I2C::_txBegin() ------------------------
+ *
+ * start a data transaction. Held commands go first, each with a Co=1
+ * control byte, so window and data share one START and address.
+ * Follow with _txByte() data bytes and _txEnd().
  *
- * send data byte array to OLED on I2C
+ * e.g. a 128 byte page write, SSD1306:
+ *   window then data:  2 transactions, 2+4 + 2+128 = 136 bytes
+ *   merged:            1 transaction,  1+8 + 1+128 = 138 bytes
+ * The START/STOP and bus free time saved are worth more than the 2 bytes,
+ * and nothing else on the bus can get between the window and its data.
 */
 
-void OLED_I2C::_txDat( uint8_t dat[], uint16_t siz )
+void OLED_I2C::_txBegin()
 {
-  i2c_start( OLED_I2C_ADR << 1 );
+  if( _bus )                    /* queue for the bus scheduler instead     */
+  {
+    _bus->_begin( _slot, _cmdQ, _cmdN );
+    _cmdN = 0;
+    return;
+  }
   
-  i2c_byte( DISPLAY_DATA );
+  I2C_START( _adr << 1 );
   
-  for( uint16_t byt = 0; byt < siz; byt++ ) 
+  for( uint8_t byt = 0; byt < _cmdN; byt++ ) 
+  {
+    I2C_BYTE( DISPLAY_CO_COMMAND );
+    I2C_BYTE( _cmdQ[byt] );
+  }
+  _cmdN = 0;
+  
+  I2C_BYTE( DISPLAY_DATA );     /* Co=0: all following bytes are data     */
+}
+
+
+
+/*------------------------------ OLED_I2C::_txEnd() --------------------------
+ *
+ * end a data transaction
+*/
+
+void OLED_I2C::_txEnd()
+{
+  if( _bus )
   {
-    i2c_byte( dat[byt] );
+    _bus->_end( _slot );
+    return;
   }
-  i2c_stop();
+  
+  I2C_STOP();
   
   _report_if_I2C_error();
 }
 
 
 
+/*------------------------------ OLED_I2C::_txByte() -------------------------
+ *
+ * send one data byte of an open data transaction
+*/
+
+void OLED_I2C::_txByte( uint8_t byt )
+{
+  if( _bus )
+  {
+    _bus->_put( _slot, byt );
+  }
+  else
+  {
+    I2C_BYTE( byt );
+  }
+}
+
+
+
+/*--------------------------- OLED_I2C::_txDat() ----------------------------
+ *
+ * send held commands and data byte array to OLED on I2C
+*/
+
+void OLED_I2C::_txDat( uint8_t dat[], uint16_t siz )
+{
+  _txBegin();
+  
+  for( uint16_t byt = 0; byt < siz; byt++ ) 
+  {
+    _txByte( dat[byt] );
+  }
+  _txEnd();
+}
+
+
+
 /*----------------------------- OLED_I2C::init() ---------------------------
  *
  * Init OLED and gets Serial obj addr for error printing
@@ -128,7 +237,7 @@ void OLED_I2C::init( Stream * serialObj )
 {
   _serialRef = serialObj;     /* print errors to Serial Monitor though this */
   
-  i2c_init();
+  I2C_INIT();
 
   _serialRef->println( buf );     /* buf[] has string of pixel sizes & chip */
   
@@ -141,6 +250,11 @@ void OLED_I2C::init( Stream * serialObj )
   
   _txCmd( cmdSeq, sizeof(cmdSeq) );
   
+  if( _rot != ROTATE_0 )  /* rotate() called before init() */
+  {
+    _remap();
+  }
+  
   clearScreen(); /* also sets xPos/yPos to zero */
 
   putRAM( buf );
@@ -148,6 +262,57 @@ void OLED_I2C::init( Stream * serialObj )
 
 
 
+#if defined OLED_SOFT_I2C
+
+/*----------------------------- OLED_I2C::lanes() ---------------------------
+ *
+ * select the soft I2C SDA lane(s), one bit per port pin. Following writes
+ * go to all selected displays at once, e.g. init() or clearScreen().
+ * Call before init() to init them all, init() keeps the lanes selected.
+*/
+
+void OLED_I2C::lanes( uint8_t sdaMask )
+{
+  si2c_lanes( sdaMask );
+}
+
+
+
+/*----------------------------- OLED_I2C::putSpanLanes() --------------------
+ *
+ * put a different span on each selected lane, same page, colPx and siz.
+ * The window and control bytes are the same on all lanes, only the data
+ * bytes differ, sent with si2c_byteLanes(). Ignored for a display on
+ * OLED_Bus, the bus queue has one byte per data byte.
+*/
+
+void OLED_I2C::putSpanLanes( uint8_t page, uint8_t colPx, uint8_t * dat[8], uint8_t siz )
+{
+  if( _bus )                    /* lane bytes would go out with no START */
+  {
+    return;
+  }
+  uint8_t byts[8];
+
+  _window( page, colPx, colPx + siz - 1 );
+
+  _txBegin();
+
+  for( uint8_t i = 0; i < siz; i++ )
+  {
+    for( uint8_t lane = 0; lane < 8; lane++ )
+    {
+      byts[lane] = dat[lane] ? dat[lane][i] : 0;
+    }
+    si2c_byteLanes( byts );
+  }
+  _txEnd();
+}
+
+#endif
+
+
+
 /*----------------------------- OLED_I2C::_cursor() -------------------------
  *
  * set _cursor position to chr#, line#    0, 0 is top left.
@@ -168,31 +333,46 @@ void OLED_I2C::_cursor( int8_t xPos, int8_t yPos ) /* xPos & yPos default -1 */
     y = yPos;  /* use new yPos */ 
   }
 
-  if( ( x <= CHARS_WIDE) && ( y <= CHARS_HIGH) ) /* inside screen area? */
+  if( ( x <= charsWide() ) && ( y <= charsHigh() ) ) /* inside screen area? */
   {
     _xPos = x;
     _yPos = y;
-    uint8_t xPx = ( x * sizeof(FONT[0]) );
-  
-    uint8_t cmdSeq[] = 
+    
+    if( ! _portrait() )   /* portrait chars each set their own window */
     {
-      (uint8_t) ( 0xb0 + y ),
-      0x21,
-  #if defined SSD1306 || defined SSD1309
-      xPx,    
-  #elif defined SH1106 
-      0x00 + ( ( 2 + xPx ) & 0x0f ),
-      0x10 + ( ( ( 2 + xPx ) & 0xf0 ) >> 4 ),     
-  #endif  
-      0x7f
-    };
-  
-    _txCmd( cmdSeq, sizeof(cmdSeq) );
+      _window( y, x * sizeof(FONT[0]), OLED_PX_HOR - 1 );
+    }
   }
 }
 
 
 
+/*----------------------------- OLED_I2C::_window() -------------------------
+ *
+ * set RAM window to page, columns colPx to colEnd. Data then fills the page
+ * from colPx and wraps back to colPx after colEnd (SSD1306/SSD1309).
+*/
+
+void OLED_I2C::_window( uint8_t page, uint8_t colPx, uint8_t colEnd )
+{
+  uint8_t cmdSeq[] = 
+  {
+    (uint8_t) ( 0xb0 + page ),
+#if defined SSD1306 || defined SSD1309
+    0x21,
+    colPx,    
+    colEnd
+#elif defined SH1106 
+    (uint8_t) ( 0x00 + ( ( 2 + colPx ) & 0x0f ) ),
+    (uint8_t) ( 0x10 + ( ( ( 2 + colPx ) & 0xf0 ) >> 4 ) )
+#endif  
+  };
+
+  _queueCmd( cmdSeq, sizeof(cmdSeq) );  /* goes out with the next data */
+}
+
+
+
 /*------------------------ OLED_I2C::clearScreen() ----------------------------
  *
  * clear the display screen
@@ -200,15 +380,33 @@ void OLED_I2C::_cursor( int8_t xPos, int8_t yPos ) /* xPos & yPos default -1 */
 
 void OLED_I2C::clearScreen()
 {
+#if defined SSD1306 || defined SSD1309
+                          /* horizontal addressing wraps page to page, so  */
+                          /*   one transaction clears all pages. Own window*/
+  _window( 0, 0, OLED_PX_HOR - 1 );   /* as portrait _cursor() sets none  */
+  
+  _txBegin();
+  
+  for( uint16_t byt = 0; byt < OLED_PX_HOR * CHARS_HIGH; byt++ )
+  {
+    _txByte( 0 );
+  }
+  _txEnd();
+  
+#elif defined SH1106      /* SH1106 has only page addressing               */
   uint8_t buf[ OLED_PX_HOR ];
   
   memset( buf, 0, sizeof(buf) );  /* fast fill buf[] with 0s */
   
   for( int8_t line = CHARS_HIGH -1; line >= 0 ; line-- )
   {
-    _cursor( 0, line );
+    _window( line, 0, OLED_PX_HOR - 1 );
     _txDat( buf, sizeof(buf) );
   }
+#endif
+
+  _xPos = 0;              /* cursor top left, as before */
+  _yPos = 0;
 }
 
 
@@ -216,26 +414,58 @@ void OLED_I2C::clearScreen()
 /*---------------------------- OLED_I2C::execute() --------------------------
  *
  * exeute display command... Normal/Inverse, Sleep/Awake
+ * hold true keeps the command to go out with the next call, so e.g.
+ *   contrast( 200, true ); execute( DISPLAY_INVERSE );  is one transaction
 */
 
-void OLED_I2C::execute( DISPLAY_t cmdByte )
+void OLED_I2C::execute( DISPLAY_t cmdByte, bool hold )
 {
   uint8_t cmdSeq[1] = { cmdByte };
 
-  _txCmd( cmdSeq, 1);
+  if( hold )
+  {
+    _queueCmd( cmdSeq, 1 );
+  }
+  else
+  {
+    _txCmd( cmdSeq, 1 );
+  }
 }
 
 
 
 /*------------------------- OLED_I2C::contrast() ---------------------------
  *
- *
+ * set display contrast, 0 to 255. hold as execute()
 */
 
-void OLED_I2C::contrast( uint8_t contrast )
+void OLED_I2C::contrast( uint8_t contrast, bool hold )
 {
   uint8_t cmdSeq[2] = { DISPLAY_CONTRAST, contrast };
-  _txCmd( cmdSeq, 2 );
+  
+  if( hold )
+  {
+    _queueCmd( cmdSeq, 2 );
+  }
+  else
+  {
+    _txCmd( cmdSeq, 2 );
+  }
+}
+
+
+
+/*----------------------------- OLED_I2C::putSpan() -------------------------
+ *
+ * put RAM bytes on screen at page (0 to 7), pixel column colPx. 
+ * Each byte is one pixel column, bit 0 at top. siz 1 to 128.
+*/
+
+void OLED_I2C::putSpan( uint8_t page, uint8_t colPx, uint8_t dat[], uint8_t siz )
+{
+  _window( page, colPx, colPx + siz - 1 );
+  
+  _txDat( dat, siz );
 }
 
 
@@ -243,28 +473,66 @@ void OLED_I2C::contrast( uint8_t contrast )
 /*----------------------------- OLED_I2C::_putChar() -------------------------
  *
  * put char on screen, if pos is on-screen & printable. Increments xPos.
+ * Data transaction must be open, see _txBegin().
 */
 
 void OLED_I2C::_putChar( char chr )
 {
-  if( _xPos < CHARS_WIDE && chr >= ' ' )   /* is chr on-screen & printable? */
+  if( _xPos < charsWide() && chr >= ' ' )  /* is chr on-screen & printable? */
   {
     uint8_t indx = chr - ' ';              /* get index in FONT[]           */
   
-    uint8_t dat[sizeof(FONT[0])];
-  
-  	for( uint8_t byt = 0; byt < sizeof(FONT[0]); byt++ ) /* get font to RAM */
+    if( _portrait() )                      /* 8x8 tile, own transaction     */
     {
-      dat[byt] = pgm_read_byte( & ( FONT[indx][byt] ) ); /* ...from PROGMEM */
+      uint8_t tile[8] = { 0 };
+      
+      memcpy_P( tile, FONT[indx], sizeof(FONT[0]) );
+      
+      _putTile( tile, _xPos, _yPos );
+    }
+    else
+    {
+    	for( uint8_t byt = 0; byt < sizeof(FONT[0]); byt++ ) 
+      {
+        _txByte( pgm_read_byte( & ( FONT[indx][byt] ) ) ); /* from PROGMEM */
+      }
     }
-    _txDat( dat, sizeof(FONT[0]) );
-    
     _xPos++;
   }
 }
 
 
 
+/*----------------------------- OLED_I2C::_putStr() -------------------------
+ *
+ * put RAM or PROGMEM string on screen from xPos, yPos. Landscape sends the
+ * window and whole string in one transaction.
+*/
+
+void OLED_I2C::_putStr( const char * str, bool prog )
+{
+  bool landscape = ! _portrait();
+  
+  if( landscape )
+  {
+    _txBegin();
+  }
+  
+  char chr;
+  while( ( chr = prog ? pgm_read_byte( str ) : * str ) ) /* not zero char */
+  {
+    _putChar( chr );
+    str++;
+  }
+  
+  if( landscape )
+  {
+    _txEnd();
+  }
+}
+
+
+
 /*----------------------------- OLED_I2C::putRAM() ------------------------
  *
  * put RAM array of zero-terminated C style string on screen
@@ -275,10 +543,7 @@ void OLED_I2C::putRAM( const char * ram_str, int8_t xPos, int8_t yPos )
 {
   _cursor( xPos, yPos );
   
-  while( * ram_str )  /* while not zero char */
-  {
-    _putChar( * ram_str ++ );
-  }
+  _putStr( ram_str, false );
 }
 
 
@@ -290,14 +555,367 @@ void OLED_I2C::putRAM( const char * ram_str, int8_t xPos, int8_t yPos )
 
 void OLED_I2C::putPROG( const char * prog_str, int8_t xPos, int8_t yPos )
 {
-
   _cursor( xPos, yPos );
   
-  char chr;
-  while( ( chr = pgm_read_byte( prog_str ++ ) ) ) /* while not zero char */
+  _putStr( prog_str, true );
+}
+
+
+/*----------------------------- OLED_I2C::marqueeRAM() ---------------------
+ *
+ * scroll RAM string along line yPos, see marqueeTick(). The string is
+ * read at every tick, so must not go out of scope while scrolling.
+*/
+
+void OLED_I2C::marqueeRAM( const char * ram_str, int8_t yPos )
+{
+  _marquee( ram_str, false, yPos );
+}
+
+
+
+/*----------------------------- OLED_I2C::marqueePROG() --------------------
+ *
+ * scroll flash/PROGMEM string along line yPos, see marqueeTick()
+*/
+
+void OLED_I2C::marqueePROG( const char * prog_str, int8_t yPos )
+{
+  _marquee( prog_str, true, yPos );
+}
+
+
+
+/*----------------------------- OLED_I2C::_marquee() -----------------------
+ *
+ * start software marquee. String enters from the right.
+ * Ignored if yPos is not a line, e.g. -1, or the display is portrait.
+*/
+
+void OLED_I2C::_marquee( const char * str, bool prog, int8_t yPos )
+{
+  if( ! _marqueeLine( yPos ) )
   {
-    _putChar( chr );
+    return;
+  }
+  marqueeStop();
+  
+  _mqStr  = str;
+  _mqProg = prog;
+  _mqLine = yPos;
+  _mqOff  = 0;
+  
+  size_t len = prog ? strlen_P( str ) : strlen( str );
+  
+  _mqLen  = len < 200 ? len : 200;   /* max 200 chars, keeps indx 8 bit */
+}
+
+
+
+/*----------------------------- OLED_I2C::_marqueeLine() --------------------
+ *
+ * yPos is a landscape line. -1 would make page command 0xAF, DISPLAY_AWAKE.
+*/
+
+bool OLED_I2C::_marqueeLine( int8_t yPos )
+{
+  return yPos >= 0 && yPos < CHARS_HIGH && ! _portrait();
+}
+
+
+
+/*----------------------------- OLED_I2C::_marqueeChar() --------------------
+ *
+ * char indx of marquee string, space when past end or not printable
+*/
+
+char OLED_I2C::_marqueeChar( uint8_t indx )
+{
+  if( indx >= _mqLen )
+  {
+    return ' ';
+  }
+  char chr = _mqProg ? pgm_read_byte( _mqStr + indx ) : _mqStr[indx];
+  
+  return chr >= ' ' ? chr : ' ';
+}
+
+
+
+/*----------------------------- OLED_I2C::marqueeTick() ---------------------
+ *
+ * scroll the marquee 1 pixel left. Only the 128 visible columns are made,
+ * straight from FONT, and sent as one transaction. When the string has
+ * gone off the left, it enters again from the right.
+ *
+ * per tick: 1 + 8 window + 1 + 128 = 138 bytes on I2C, 12.4ms at 100kHz,
+ *   3.1ms at 400kHz (checked by extras/host/marquee_test). Making the
+ *   columns is estimated, not timed, at ~20 cycles each, ~0.2ms at
+ *   16MHz, so the bus sets the tick rate.
+*/
+
+void OLED_I2C::marqueeTick()
+{
+  if( ! _mqStr )
+  {
+    return;
+  }
+  _window( _mqLine, 0, OLED_PX_HOR - 1 );
+  
+  _txBegin();
+  
+  int16_t px  = (int16_t) _mqOff - OLED_PX_HOR;  /* string px at column 0 */
+  uint8_t col = 0;
+  
+  for( ; px < 0 && col < OLED_PX_HOR; px++, col++ )  /* before string */
+  {
+    _txByte( 0 );
+  }
+  
+  uint8_t indx = px / sizeof(FONT[0]);           /* char at col         */
+  uint8_t byt  = px % sizeof(FONT[0]);           /*   and its column    */
+  char    chr  = _marqueeChar( indx );
+  
+  for( ; col < OLED_PX_HOR; col++ )
+  {
+    _txByte( pgm_read_byte( & ( FONT[chr - ' '][byt] ) ) );
+    
+    if( ++byt == sizeof(FONT[0]) )
+    {
+      byt = 0;
+      chr = _marqueeChar( ++indx );
+    }
+  }
+  _txEnd();
+  
+  if( ++_mqOff >= _mqLen * sizeof(FONT[0]) + OLED_PX_HOR )
+  {
+    _mqOff = 0;
+  }
+}
+
+
+
+#if defined SSD1306 || defined SSD1309
+
+/*----------------------------- OLED_I2C::marqueeHW() -----------------------
+ *
+ * controller scrolls line yPos round and round, no CPU or I2C cost.
+ * Only what is on the line already scrolls, so at most CHARS_WIDE chars.
+ * interval is frames per pixel step:
+ *   0=5, 1=64, 2=128, 3=256, 4=3, 5=4, 6=25, 7=2
+ * Ignored if yPos is not a line, as _marquee().
+*/
+
+void OLED_I2C::marqueeHW( int8_t yPos, bool left, uint8_t interval )
+{
+  if( ! _marqueeLine( yPos ) )
+  {
+    return;
+  }
+  marqueeStop();
+  
+  uint8_t cmdSeq[] =
+  {
+    (uint8_t) ( left ? 0x27 : 0x26 ),  /* horizontal scroll left/right  */
+    0x00,                              /* dummy                         */
+    (uint8_t) yPos,                    /* start page                    */
+    (uint8_t) ( interval & 0x07 ),     /* frames per step               */
+    (uint8_t) yPos,                    /* end page                      */
+    0x00,                              /* dummy                         */
+    0xFF,                              /* dummy                         */
+    0x2F                               /* activate scroll               */
+  };
+  
+  _txCmd( cmdSeq, sizeof(cmdSeq) );
+}
+
+#endif
+
+
+
+/*----------------------------- OLED_I2C::marqueeStop() ---------------------
+ *
+ * stop software marquee, and the hardware scroll. After a hardware scroll
+ * the line should be written again, the controller may have changed it.
+*/
+
+void OLED_I2C::marqueeStop()
+{
+  _mqStr = nullptr;
+  
+#if defined SSD1306 || defined SSD1309
+  uint8_t cmdSeq[1] = { 0x2E };        /* deactivate scroll             */
+  
+  _queueCmd( cmdSeq, 1 );              /* goes with the next write      */
+#endif
+}
+
+
+/*----------------------------- OLED_I2C::charsWide() -----------------------
+ *
+ * chars per line. Portrait has 8 pixel wide char cells.
+*/
+
+int8_t OLED_I2C::charsWide()
+{
+  return _portrait() ? OLED_PX_VERT / 8 : CHARS_WIDE;
+}
+
+
+
+/*----------------------------- OLED_I2C::charsHigh() -----------------------
+ *
+ * lines on screen
+*/
+
+int8_t OLED_I2C::charsHigh()
+{
+  return _portrait() ? OLED_PX_HOR / 8 : CHARS_HIGH;
+}
+
+
+
+/*----------------------------- OLED_I2C::rotate() --------------------------
+ *
+ * set display orientation. 0/180 and mirrors are the controller segment
+ * remap and COM scan direction, no CPU cost. 90/270 write each 8x8 cell
+ * transposed, with one controller flip to make it a rotation.
+ * The RAM is not redrawn, so clearScreen() and write again after.
+ * Marquees are landscape only, so a running one stops for portrait.
+*/
+
+void OLED_I2C::rotate( ROTATE_t rot )
+{
+  _rot  = rot;
+  _xPos = 0;
+  _yPos = 0;
+  
+  if( _portrait() )
+  {
+    marqueeStop();
   }
+  _remap();
+}
+
+
+
+/*----------------------------- OLED_I2C::_remap() --------------------------
+ *
+ * hold segment remap & COM scan commands for _rot, go with next write
+*/
+
+void OLED_I2C::_remap()
+{
+  static const uint8_t remap[][2] PROGMEM =  /* seg remap, COM scan, by _rot */
+  {
+    { 0xA1, 0xC8 },                          /* ROTATE_0,   as _initSeq     */
+    { 0xA0, 0xC8 },                          /* ROTATE_90,  x flipped       */
+    { 0xA0, 0xC0 },                          /* ROTATE_180, x & y flipped   */
+    { 0xA1, 0xC0 },                          /* ROTATE_270, y flipped       */
+    { 0xA0, 0xC8 },                          /* MIRROR_H                    */
+    { 0xA1, 0xC0 }                           /* MIRROR_V                    */
+  };
+  
+  uint8_t cmdSeq[2];
+  
+  memcpy_P( cmdSeq, remap[_rot], 2 );
+  
+  _queueCmd( cmdSeq, 2 );
+}
+
+
+
+/*----------------------------- OLED_I2C::transpose8() ----------------------
+ *
+ * transpose 8x8 bit matrix, out[j] bit i = in[i] bit j. Three delta swaps,
+ * of 1 bit in each 2x2, 2x2 in each 4x4 and 4x4 in the 8x8, each on 4 row
+ * pairs, in place of 64 single bit moves.
+ *
+ * All on bytes: shifts are by 1, 2 or 4 (a nibble swap on AVR), so there
+ * are no 32 bit shifts, which avr-gcc makes into loops. Not timed.
+*/
+
+void OLED_I2C::transpose8( const uint8_t in[8], uint8_t out[8] )
+{
+  uint8_t r[8];
+  uint8_t t;
+  
+  memcpy( r, in, 8 );               /* in and out may be the same         */
+  
+  for( uint8_t i = 0; i < 8; i += 2 )          /* 1 bit in 2x2, rows i, i+1 */
+  {
+    t = ( ( r[i] >> 1 ) ^ r[i + 1] ) & 0x55;
+    r[i + 1] ^= t;
+    r[i]     ^= t << 1;
+  }
+  for( uint8_t i = 0; i < 8; i += ( i & 1 ) ? 3 : 1 )  /* 2x2 in 4x4,       */
+  {                                                    /*   rows i, i+2     */
+    t = ( ( r[i] >> 2 ) ^ r[i + 2] ) & 0x33;
+    r[i + 2] ^= t;
+    r[i]     ^= t << 2;
+  }
+  for( uint8_t i = 0; i < 4; i++ )             /* 4x4 in 8x8, rows i, i+4   */
+  {
+    t = ( ( r[i] >> 4 ) ^ r[i + 4] ) & 0x0F;
+    r[i + 4] ^= t;
+    r[i]     ^= t << 4;
+  }
+  memcpy( out, r, 8 );
+}
+
+
+
+/*----------------------------- OLED_I2C::_putTile() ------------------------
+ *
+ * put RAM tile at 8 pixel cell, transposed in place when portrait
+*/
+
+void OLED_I2C::_putTile( uint8_t tile[8], uint8_t xCell, uint8_t yCell )
+{
+  if( _portrait() )
+  {
+    transpose8( tile, tile );
+    
+    _window( xCell, yCell * 8, yCell * 8 + 7 );
+  }
+  else
+  {
+    _window( yCell, xCell * 8, xCell * 8 + 7 );
+  }
+  _txDat( tile, 8 );
+}
+
+
+
+/*----------------------------- OLED_I2C::putTile() -------------------------
+ *
+ * put RAM 8x8 tile at cell xCell, yCell in the current orientation
+*/
+
+void OLED_I2C::putTile( const uint8_t tile[8], uint8_t xCell, uint8_t yCell )
+{
+  uint8_t dat[8];
+  
+  memcpy( dat, tile, 8 );
+  
+  _putTile( dat, xCell, yCell );
+}
+
+
+
+/*----------------------------- OLED_I2C::putTilePROG() ---------------------
+ *
+ * put flash/PROGMEM 8x8 tile at cell xCell, yCell
+*/
+
+void OLED_I2C::putTilePROG( const uint8_t * prog_tile, uint8_t xCell, uint8_t yCell )
+{
+  uint8_t dat[8];
+  
+  memcpy_P( dat, prog_tile, 8 );
+  
+  _putTile( dat, xCell, yCell );
 }
 
 
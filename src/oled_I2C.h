@@ -7,7 +7,8 @@
 *         © Dave Harris, 2021 (Andover, UK) MERG M2740
 *
 *
-* Comprises oled_I2C.h, oled_I2C.cpp, i2c.h, i2c.c, font_Monospaced7x5.h
+* Comprises oled_I2C.h, oled_I2C.cpp, i2c.h, i2c.c, font_Monospaced7x5.h,
+*           soft_i2c.h, soft_i2c.c
 * 
 * 
 * 
@@ -98,26 +99,61 @@
 /* If the I2C is disconnected, the I2C.h library does NOT hang the program   */
 /*    This library creates a global variable I2C_ErrorFlag                   */
 
-#define OLED_I2C_ADR ( 0x78 >> 1 )    /* 7 bit slave-adress without r/w-bit  */
+#define OLED_I2C_ADR ( 0x78 >> 1 )    /* default 7 bit slave-adress, no r/w-bit */
 
 #include "i2c.h"	                    /* I2C communication library (basic)   */
 
 
 
+/* define OLED_SOFT_I2C to use soft_i2c.h instead of the hardware TWI.       */
+/*    SCL & SDA pins are set in soft_i2c.h. Several SDA lanes on one port    */
+/*    drive same address displays in parallel, see OLED_I2C::lanes()        */
+
+//#define OLED_SOFT_I2C
+
+#if defined OLED_SOFT_I2C
+  #include "soft_i2c.h"               /* bit-banged I2C on any port pins     */
+  #define I2C_INIT()      si2c_init( SI2C_SDA )
+  #define I2C_START( a )  si2c_start( a )
+  #define I2C_BYTE( b )   si2c_byte( b )
+  #define I2C_STOP()      si2c_stop()
+  #define OLED_I2C_HZ     F_SI2C
+#else
+  #define I2C_INIT()      i2c_init()
+  #define I2C_START( a )  i2c_start( a )
+  #define I2C_BYTE( b )   i2c_byte( b )
+  #define I2C_STOP()      i2c_stop()
+  #define OLED_I2C_HZ     F_I2C
+#endif
+
+
+
 /* save much program space by only using Monospaced 7x5 font                 */
 
 #include "font_Monospaced7x5.h"
 
 
 
+class OLED_Bus;                         /* multi-display bus, oled_Bus.h  */
+class OLED_Stream;                      /* serial frames, oled_Stream.h   */
+class OLED_Strip;                       /* strip graphics, oled_Strip.h   */
+
+
 class OLED_I2C
 {
+  friend class OLED_Bus;
+  friend class OLED_Stream;
+  friend class OLED_Strip;
+  
   public:
   
+    OLED_I2C( uint8_t adr = OLED_I2C_ADR ) : _adr( adr ) {}  /* 7 bit adr  */
+  
     enum DISPLAY_t : uint8_t                      /* OLED execute commands   */
     {
       DISPLAY_DATA     = 0x40,
       DISPLAY_COMMAND  = 0x00,
+      DISPLAY_CO_COMMAND = 0x80,  /* one command, then another control byte */
       DISPLAY_NORMAL   = 0xA6,
       DISPLAY_INVERSE  = 0xA7,
       DISPLAY_SLEEP    = 0xAE,
@@ -125,10 +161,24 @@ class OLED_I2C
       DISPLAY_CONTRAST = 0x81
     };
 
+    enum ROTATE_t : uint8_t                       /* display orientation     */
+    {
+      ROTATE_0,                                   /* landscape, as init()    */
+      ROTATE_90,                                  /* portrait, clockwise     */
+      ROTATE_180,                                 /* landscape, upside down  */
+      ROTATE_270,                                 /* portrait, anticlockwise */
+      MIRROR_H,                                   /* landscape, left<>right  */
+      MIRROR_V                                    /* landscape, top<>bottom  */
+    };
+
     static const int8_t CHARS_WIDE = OLED_PX_HOR / 6;   /* for Monospaced7x5 */
     
     static const int8_t CHARS_HIGH = OLED_PX_VERT / 8;  /* for Monospaced7x5 */
 
+    int8_t charsWide();                      /* chars per line, as rotation  */
+    
+    int8_t charsHigh();                      /* lines, as rotation           */
+
    
                               /* put ram string on screen at xPos, yPos      */
                               
@@ -139,15 +189,65 @@ class OLED_I2C
                               
     void putPROG( const char * prog_str, int8_t xPos = -1, int8_t yPos = -1 ); 
 
+  
+                              /* scroll long string along line yPos, 1 pixel */
+                              /*   per marqueeTick(). String must stay put.  */
+                              /*   Landscape rotations only. yPos not a line */
+                              /*   (e.g. -1) is ignored, as is marqueeHW()'s */
+
+    void marqueeRAM( const char * ram_str, int8_t yPos );
+    void marqueePROG( const char * prog_str, int8_t yPos );
+    void marqueeTick();                      /* scroll marquee 1 pixel left  */
+
+#if defined SSD1306 || defined SSD1309
+                              /* controller scrolls line yPos, no CPU cost.  */
+                              /*   interval 0-7, see _marqueeHW() comment    */
+
+    void marqueeHW( int8_t yPos, bool left = true, uint8_t interval = 0 );
+#endif
+    void marqueeStop();                      /* stop software & hw marquee   */
+
       
     void clearScreen();                      /* clear the screen             */
+
+                              /* put pixel column bytes at page, colPx       */
+
+    void putSpan( uint8_t page, uint8_t colPx, uint8_t dat[], uint8_t siz );
       
-    void execute( DISPLAY_t cmdByte );       /* execute invert/sleep command */
+                              /* hold: send with next call, one transaction  */
+
+    void execute( DISPLAY_t cmdByte, bool hold = false ); /* invert/sleep cmd */
   
-    void contrast( uint8_t contrast );       /* adjust display contrast      */
+    void contrast( uint8_t contrast, bool hold = false ); /* adjust contrast  */
 
     void init( Stream * serialObj );         /* initialize display           */
 
+                              /* rotate or mirror. clearScreen() after it.   */
+                              /*   portrait is 8 x 8 pixel char cells        */
+
+    void rotate( ROTATE_t rot );
+
+                              /* put 8x8 tile at 8 pixel cell x, y. Each     */
+                              /*   byte a pixel column, turned for portrait  */
+
+    void putTile( const uint8_t tile[8], uint8_t xCell, uint8_t yCell );
+    void putTilePROG( const uint8_t * prog_tile, uint8_t xCell, uint8_t yCell );
+
+                              /* transpose 8x8 bits: out[j] bit i = in[i]    */
+                              /*   bit j. in and out may be the same array   */
+
+    static void transpose8( const uint8_t in[8], uint8_t out[8] );
+
+#if defined OLED_SOFT_I2C
+    void lanes( uint8_t sdaMask );           /* SDA lane(s) to write to      */
+
+                              /* putSpan, different bytes on each lane in    */
+                              /*   one pass. dat[n] for the lane on port bit */
+                              /*   n, nullptr sends 0s. Ignored on OLED_Bus  */
+
+    void putSpanLanes( uint8_t page, uint8_t colPx, uint8_t * dat[8], uint8_t siz );
+#endif
+
   
     char buf[CHARS_WIDE]          /* general purpose display string buffer   */
     {                             /*   initially screen shows the chip/size  */
@@ -162,12 +262,50 @@ class OLED_I2C
     void _report_if_I2C_error();                /* check error and print msg */
 
     void _cursor( int8_t xPos, int8_t yPos );   /* cursor to char# and line# */
+
+    void _window( uint8_t page, uint8_t colPx, uint8_t colEnd ); /* RAM window */
   
     void _putChar( char chr );                  /* put character on screen   */
   
+    void _putStr( const char * str, bool prog ); /* put string on screen     */
+  
+    void _putTile( uint8_t tile[8], uint8_t xCell, uint8_t yCell ); /* tile  */
+  
+    void _remap();                              /* send _rot remap commands  */
+  
+    bool _portrait() { return _rot == ROTATE_90 || _rot == ROTATE_270; }
+  
+    ROTATE_t _rot = ROTATE_0;                   /* orientation               */
+  
+    void _queueCmd( const uint8_t cmd[], uint8_t siz ); /* hold commands     */
+  
     void _txCmd( uint8_t cmd[], uint8_t siz );  /* transmit command sequence */ 
     void _txDat( uint8_t dat[], uint16_t siz ); /* transmit data sequence    */
   
+    void _txBegin();                            /* start data transaction    */
+    void _txByte( uint8_t byt );                /* data byte in transaction  */
+    void _txEnd();                              /* end data transaction      */
+  
+    uint8_t    _adr;                            /* 7 bit I2C address         */
+    
+    OLED_Bus * _bus = nullptr;                  /* set by OLED_Bus::add()    */
+    uint8_t    _slot;                           /* slot on _bus              */
+  
+    uint8_t _cmdQ[10];                          /* held commands             */
+    uint8_t _cmdN = 0;                          /* held commands count       */
+  
+    void _marquee( const char * str, bool prog, int8_t yPos ); /* start it   */
+    
+    bool _marqueeLine( int8_t yPos );           /* yPos ok for a marquee     */
+
+    char _marqueeChar( uint8_t indx );          /* char of marquee string    */
+  
+    const char * _mqStr = nullptr;              /* marquee string, or none   */
+    bool         _mqProg;                       /* string is in PROGMEM      */
+    uint8_t      _mqLen;                        /* string length, chars      */
+    uint8_t      _mqLine;                       /* line# it scrolls on       */
+    uint16_t     _mqOff;                        /* scroll pixel offset       */
+  
     int8_t  _xPos = 0;                          /* track character position  */
     int8_t  _yPos = 0;                          /* track line number         */
       
@@ -0,0 +1,248 @@
+/* file: oled_Stream.cpp
+*--------------------------------------------------------------------------
+*
+* live frames from a PC to the display, over the Stream given to init().
+*
+*  © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*/
+
+#include "oled_Stream.h"
+
+
+
+/*------------------------------- OLED_Stream::begin() ----------------------
+ *
+ * reset receive state and stats, grant the PC a credit for each buffer
+*/
+
+void OLED_Stream::begin()
+{
+  _state  = RX_SYNC;
+  _resync = false;
+  _fill   = 0;
+  _send   = 0;
+  _frames = 0;
+  _errors = 0;
+  _begin  = millis();
+
+  for( uint8_t i = 0; i < 2; i++ )
+  {
+    _buf[i].ready = false;
+
+    _oled._serialRef->write( STREAM_CREDIT );
+  }
+}
+
+
+
+/*------------------------------- OLED_Stream::poll() -----------------------
+ *
+ * read what has arrived, then send the next received span on I2C. The
+ * Stream is read again every STREAM_CHUNK bytes, to fill the other buffer.
+*/
+
+bool OLED_Stream::poll()
+{
+  _rx();
+
+  if( _resync && ! _buf[0].ready && ! _buf[1].ready )
+  {
+    _resync = false;
+
+    _oled._serialRef->write( STREAM_SYNCED );  /* every reply is sent */
+  }
+
+  _Buf & b = _buf[_send];
+
+  if( ! b.ready )
+  {
+    return false;
+  }
+
+  _oled._window( b.page, b.col, b.col + b.siz - 1 );
+
+  _oled._txBegin();
+
+  for( uint8_t i = 0; i < b.siz; i++ )
+  {
+    _oled._txByte( b.dat[i] );
+
+    if( ( i % STREAM_CHUNK ) == STREAM_CHUNK - 1 )
+    {
+      _rx();                      /* overlap receive with I2C transmit */
+    }
+  }
+  _oled._txEnd();
+
+  b.ready = false;
+  _send  ^= 1;
+
+  Stream * ser = _oled._serialRef;            /* shown, buffer free    */
+
+  ser->write( STREAM_ACK );
+  ser->write( b.page );
+  ser->write( b.col );
+  ser->write( b.siz );
+
+  return true;
+}
+
+
+
+/*------------------------------- OLED_Stream::fps() ------------------------
+ *
+ * frames per second received and shown since begin()
+*/
+
+uint16_t OLED_Stream::fps()
+{
+  uint32_t ms = millis() - _begin;
+
+  return ms ? (uint32_t) _frames * 1000UL / ms : 0;
+}
+
+
+
+/*------------------------------- OLED_Stream::_rx() ------------------------
+ *
+ * read arrived bytes through the receive state machine, into _buf[_fill].
+ * Stops while the fill buffer is still waiting to be sent. A packet part
+ * received is dropped when no more has come for STREAM_RX_MS.
+*/
+
+void OLED_Stream::_rx()
+{
+  Stream * ser = _oled._serialRef;
+
+  if( _state != RX_SYNC && ser->available() <= 0 &&
+      millis() - _rxMs > STREAM_RX_MS )
+  {
+    _errors++;                                /* rest lost, PC resyncs    */
+    _state = RX_SYNC;
+  }
+
+  while( ! _buf[_fill].ready && ser->available() > 0 )
+  {
+    uint8_t byt = ser->read();
+    _Buf &  b   = _buf[_fill];
+
+    _rxMs = millis();
+
+    switch( _state )
+    {
+      case RX_SYNC:
+        if( byt == STREAM_SYNC )
+        {
+          _crc   = 0;
+          _state = RX_TYPE;
+        }
+        continue;                             /* sync byte is not in crc  */
+
+      case RX_TYPE:
+        _type  = byt;
+        _state = byt == STREAM_SPAN   ? RX_PAGE
+               : byt == STREAM_END    ? RX_CRC
+               : byt == STREAM_RESYNC ? RX_CRC
+               :                        RX_SYNC;  /* unknown, resync    */
+        break;
+
+      case RX_PAGE:
+        b.page = byt;
+        _state = RX_COL;
+        break;
+
+      case RX_COL:
+        b.col  = byt;
+        _state = RX_LEN;
+        break;
+
+      case RX_LEN:
+        b.siz  = byt;
+        _got   = 0;
+        _state = RX_DATA;
+
+        if( byt == 0 || byt > OLED_PX_HOR )   /* bad size, drop the span  */
+        {
+          _errors++;
+          _state = RX_SYNC;
+          _nak( b );
+        }
+        break;
+
+      case RX_DATA:
+        b.dat[_got++] = byt;
+
+        if( _got == b.siz )
+        {
+          _state = RX_CRC;
+        }
+        break;
+
+      case RX_CRC:
+        _state = RX_SYNC;
+
+        if( _type == STREAM_END )
+        {
+          if( _crc == byt )
+          {
+            _frames++;
+          }
+        }
+        else if( _type == STREAM_RESYNC )
+        {
+          _resync |= _crc == byt;
+        }
+        else if( _crc == byt && b.page < OLED_PX_VERT / 8 &&
+                 b.col + b.siz <= OLED_PX_HOR )
+        {
+          b.ready = true;
+          _fill  ^= 1;
+        }
+        else                                  /* PC must send it again    */
+        {
+          _errors++;
+          _nak( b );
+        }
+        continue;                             /* nor is the crc byte      */
+    }
+    _crc = _crc8( _crc, byt );
+  }
+}
+
+
+
+/*------------------------------- OLED_Stream::_nak() -----------------------
+ *
+ * tell the PC which span was dropped, so it sends it again
+*/
+
+void OLED_Stream::_nak( _Buf & b )
+{
+  Stream * ser = _oled._serialRef;
+
+  ser->write( STREAM_NAK );
+  ser->write( b.page );
+  ser->write( b.col );
+}
+
+
+
+/*------------------------------- OLED_Stream::_crc8() ----------------------
+ *
+ * CRC-8, poly 0x07, one byte
+*/
+
+uint8_t OLED_Stream::_crc8( uint8_t crc, uint8_t byt )
+{
+  crc ^= byt;
+
+  for( uint8_t bit = 0; bit < 8; bit++ )
+  {
+    crc = crc & 0x80 ? ( crc << 1 ) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+
+/*----------------------------- eof oled_Stream.cpp -------------------------*/
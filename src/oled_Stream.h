@@ -0,0 +1,150 @@
+/* file oled_Stream.h
+*---------------------------------------------------------------------------
+*
+* live frames from a PC to the display, over the Stream given to init().
+*
+* Spans of pixel columns are received into one of two buffers while the
+* other is sent on I2C. Between every few I2C bytes the Stream is read,
+* so receiving the next span goes on while the current one is sent.
+*
+* Flow control is by credits: one credit per free buffer. The PC sends a
+* span only while it has credit. begin() grants both buffers, and each
+* span's ACK or NAK gives its credit back. Replies name the span, as a
+* span lost on the way gets none.
+*
+* The Stream is read between I2C bytes, at most about 26 bytes apart (the
+* window commands and a chunk), 2.3ms at 100kHz. The Arduino serial
+* receive buffer is 64 bytes, so the baud rate must be at most
+* STREAM_MAX_BAUD: 115200 with I2C at 100kHz, 500000 at 400kHz. Faster,
+* bytes are lost while a span is sent. The rate must also be one the UART
+* makes closely: at 16MHz 115200 is 2.1% off and 500000 exact, but
+* 460800 gives 500000, 8.5% off.
+*
+* extras/oled_stream_send is the PC sender.
+*
+*         © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*------------------------------- protocol ------------------------------------
+*
+* PC to board:
+*   span:         0xA5, 'S', page, column, n (1 to 128), n bytes, crc
+*   end of frame: 0xA5, 'E', crc
+*   resync:       0xA5, 'R', crc
+*   crc is CRC-8 (poly 0x07, init 0) of the bytes after 0xA5.
+*   A full frame is a span of 128 for each page, then end of frame.
+*   A packet part received is dropped if no byte comes for STREAM_RX_MS.
+*   If a span's sync or type byte is lost, the board never sees it, so
+*   the PC sends resync when no credit has come for a while.
+*
+* board to PC:
+*   STREAM_CREDIT            a buffer is free, one more span may be sent
+*   STREAM_ACK, page, col, n span shown, buffer free. Also a credit.
+*   STREAM_NAK, page, col    bad span dropped, buffer free. Also a credit.
+*   STREAM_SYNCED            answer to resync, once both buffers are free.
+*                            Spans sent before resync with no reply yet
+*                            were lost. The PC has both credits again.
+*   These are not printable, so "!I2C" error messages can not be taken
+*   for them.
+*
+*-------------------------------Example usage---------------------------------
+*
+* OLED_I2C    oled;
+* OLED_Stream stream( oled );
+*
+* setup():  Serial.begin( 115200 );           // up to STREAM_MAX_BAUD
+*           oled.init( & Serial );
+*           stream.begin();
+*
+* loop():   stream.poll();
+*
+*------------------------------------------------------------------------------
+*/
+#ifndef _oled_Stream_H_
+#define _oled_Stream_H_
+
+
+#include "oled_I2C.h"
+
+
+#define STREAM_SYNC    0xA5
+#define STREAM_SPAN    'S'
+#define STREAM_END     'E'
+#define STREAM_RESYNC  'R'
+#define STREAM_CREDIT  0x11
+#define STREAM_ACK     0x06
+#define STREAM_NAK     0x15
+#define STREAM_SYNCED  0x16
+
+#define STREAM_RX_MS   20             /* gap that ends a part packet        */
+
+#define STREAM_CHUNK   16             /* I2C bytes between Stream reads     */
+
+                                      /* 64 byte serial buffer fills in 62  */
+                                      /*   I2C bytes, reads are 26 apart.   */
+                                      /*   400kHz: 500000, exact at 16MHz,  */
+                                      /*   buffer fills in 57 I2C bytes     */
+#define STREAM_MAX_BAUD  ( OLED_I2C_HZ >= 400000UL ? 500000UL \
+                                                 : OLED_I2C_HZ * 1152UL / 1000UL )
+
+
+
+class OLED_Stream
+{
+  public:
+
+    OLED_Stream( OLED_I2C & oled ) : _oled( oled ) {}
+
+    void begin();             /* reset and grant the PC both buffers        */
+
+    bool poll();              /* call often. true if a span was sent        */
+
+    uint16_t frames() { return _frames; }     /* end of frames received     */
+
+    uint16_t errors() { return _errors; }     /* packets dropped, bad, part */
+
+    uint16_t fps();                           /* frames/second since begin  */
+
+
+  private:
+
+    OLED_I2C & _oled;
+
+    void _rx();                               /* read what has arrived      */
+
+    static uint8_t _crc8( uint8_t crc, uint8_t byt );
+
+    enum RX_t : uint8_t                       /* receive state: next byte   */
+    {
+      RX_SYNC, RX_TYPE, RX_PAGE, RX_COL, RX_LEN, RX_DATA, RX_CRC
+    };
+
+    struct _Buf
+    {
+      uint8_t page;
+      uint8_t col;
+      uint8_t siz;
+      uint8_t dat[ OLED_PX_HOR ];
+      bool    ready;                          /* received, not yet sent     */
+    };
+
+    void _nak( _Buf & b );                    /* drop span, tell PC         */
+
+    _Buf    _buf[2];
+    uint8_t _fill  = 0;                       /* buffer receiving           */
+    uint8_t _send  = 0;                       /* buffer to send next        */
+
+    RX_t    _state = RX_SYNC;
+    uint8_t _type;
+    uint8_t _got;                             /* data bytes received        */
+    uint8_t _crc;
+    bool    _resync = false;                  /* PC asked, SYNCED to send   */
+
+    uint16_t _frames = 0;
+    uint16_t _errors = 0;
+    uint32_t _begin;                          /* millis at begin()          */
+    uint32_t _rxMs;                           /* millis last byte read      */
+
+}; /* end of class OLED_Stream */
+
+
+#endif /* _oled_Stream_H_ */
@@ -0,0 +1,283 @@
+/* file: oled_Strip.cpp
+*--------------------------------------------------------------------------
+*
+* graphics without a frame buffer, drawn a strip of pages at a time.
+*
+*  © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*/
+
+#include "oled_Strip.h"
+
+
+#define PAGES  ( OLED_PX_VERT / 8 )
+#define ROWS   ( OLED_STRIP_PAGES * 8 )     /* pixel rows in a strip        */
+
+
+
+/*------------------------------- OLED_Strip::draw() ------------------------
+ *
+ * for each strip down the screen: clear it, run drawFn to draw into it,
+ * then send it. SSD1306/SSD1309 send the strip as one transaction, the
+ * window wraps page to page. SH1106 has only page addressing, so one a page.
+*/
+
+void OLED_Strip::draw( OLED_DrawFn drawFn )
+{
+  for( uint8_t page = 0; page < PAGES; page += OLED_STRIP_PAGES )
+  {
+    _y0 = page * 8;
+
+    memset( _buf, 0, sizeof(_buf) );
+
+    drawFn( * this );
+
+#if defined SSD1306 || defined SSD1309
+    _oled._window( page, 0, OLED_PX_HOR - 1 );
+    _oled._txDat( _buf, sizeof(_buf) );
+
+#elif defined SH1106
+    for( uint8_t p = 0; p < OLED_STRIP_PAGES; p++ )
+    {
+      _oled._window( page + p, 0, OLED_PX_HOR - 1 );
+      _oled._txDat( _buf + p * OLED_PX_HOR, OLED_PX_HOR );
+    }
+#endif
+  }
+}
+
+
+
+/*------------------------------- OLED_Strip::pixel() -----------------------
+ *
+ * set or clear one pixel, if in the strip
+*/
+
+void OLED_Strip::pixel( int16_t x, int16_t y, bool on )
+{
+  int16_t ry = y - _y0;
+
+  if( x >= 0 && x < OLED_PX_HOR && ry >= 0 && ry < ROWS )
+  {
+    uint8_t & byt = _buf[ ( ry >> 3 ) * OLED_PX_HOR + x ];
+    uint8_t   bit = 1 << ( ry & 7 );
+
+    byt = on ? byt | bit : byt & ~bit;
+  }
+}
+
+
+
+/*------------------------------- OLED_Strip::hline() -----------------------
+ *
+ * horizontal line, w pixels right from x
+*/
+
+void OLED_Strip::hline( int16_t x, int16_t y, int16_t w, bool on )
+{
+  int16_t ry = y - _y0;
+
+  if( ry < 0 || ry >= ROWS )          /* not in this strip */
+  {
+    return;
+  }
+  int16_t xEnd = x + w > OLED_PX_HOR ? OLED_PX_HOR : x + w;
+
+  x = x < 0 ? 0 : x;
+
+  uint8_t * byt = & _buf[ ( ry >> 3 ) * OLED_PX_HOR ];
+  uint8_t   bit = 1 << ( ry & 7 );
+
+  for( ; x < xEnd; x++ )
+  {
+    byt[x] = on ? byt[x] | bit : byt[x] & ~bit;
+  }
+}
+
+
+
+/*------------------------------- OLED_Strip::vline() -----------------------
+ *
+ * vertical line, h pixels down from y
+*/
+
+void OLED_Strip::vline( int16_t x, int16_t y, int16_t h, bool on )
+{
+  if( x >= 0 && x < OLED_PX_HOR )
+  {
+    _column( x, y - _y0, y - _y0 + h, on );
+  }
+}
+
+
+
+/*------------------------------- OLED_Strip::line() ------------------------
+ *
+ * line from x0, y0 to x1, y1 inclusive, Bresenham. Lines wholly above
+ * or below the strip are skipped without stepping them.
+*/
+
+void OLED_Strip::line( int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool on )
+{
+  if( ( y0 < top() && y1 < top() ) || ( y0 >= bottom() && y1 >= bottom() ) )
+  {
+    return;
+  }
+  int16_t dx  =   abs( x1 - x0 );
+  int16_t dy  = - abs( y1 - y0 );
+  int8_t  sx  = x0 < x1 ? 1 : -1;
+  int8_t  sy  = y0 < y1 ? 1 : -1;
+  int16_t err = dx + dy;
+
+  for( ;; )
+  {
+    pixel( x0, y0, on );
+
+    if( x0 == x1 && y0 == y1 )
+    {
+      break;
+    }
+    int16_t e2 = 2 * err;
+
+    if( e2 >= dy )
+    {
+      err += dy;
+      x0  += sx;
+    }
+    if( e2 <= dx )
+    {
+      err += dx;
+      y0  += sy;
+    }
+  }
+}
+
+
+
+/*------------------------------- OLED_Strip::rect() ------------------------
+ *
+ * outline of w x h pixels, top left at x, y
+*/
+
+void OLED_Strip::rect( int16_t x, int16_t y, int16_t w, int16_t h, bool on )
+{
+  if( w > 0 && h > 0 )
+  {
+    hline( x, y,         w, on );
+    hline( x, y + h - 1, w, on );
+    vline( x,         y, h, on );
+    vline( x + w - 1, y, h, on );
+  }
+}
+
+
+
+/*------------------------------- OLED_Strip::fillRect() --------------------
+ *
+ * filled w x h pixels, top left at x, y
+*/
+
+void OLED_Strip::fillRect( int16_t x, int16_t y, int16_t w, int16_t h, bool on )
+{
+  int16_t xEnd = x + w > OLED_PX_HOR ? OLED_PX_HOR : x + w;
+
+  for( x = x < 0 ? 0 : x; x < xEnd; x++ )
+  {
+    _column( x, y - _y0, y - _y0 + h, on );
+  }
+}
+
+
+
+/*------------------------------- OLED_Strip::text() ------------------------
+ *
+ * RAM or PROGMEM string, top left of the first char at pixel x, y
+*/
+
+void OLED_Strip::text( int16_t x, int16_t y, const char * ram_str )
+{
+  _text( x, y, ram_str, false );
+}
+
+
+void OLED_Strip::textPROG( int16_t x, int16_t y, const char * prog_str )
+{
+  _text( x, y, prog_str, true );
+}
+
+
+
+/*------------------------------- OLED_Strip::_text() -----------------------
+ *
+ * OR the FONT columns into the strip. A char not on a page boundary is
+ * split over two pages, each page gets the glyph byte shifted into place.
+*/
+
+void OLED_Strip::_text( int16_t x, int16_t y, const char * str, bool prog )
+{
+  int16_t ry = y - _y0;
+
+  if( ry <= -8 || ry >= ROWS )        /* not in this strip */
+  {
+    return;
+  }
+  char chr;
+
+  while( ( chr = prog ? pgm_read_byte( str ) : * str ) && x < OLED_PX_HOR )
+  {
+    str++;
+
+    if( chr < ' ' )                   /* not printable */
+    {
+      continue;
+    }
+    uint8_t indx = chr - ' ';
+
+    for( uint8_t col = 0; col < sizeof(FONT[0]); col++, x++ )
+    {
+      if( x < 0 || x >= OLED_PX_HOR )
+      {
+        continue;
+      }
+      uint8_t glyph = pgm_read_byte( & ( FONT[indx][col] ) );
+
+      for( uint8_t page = 0; page < OLED_STRIP_PAGES; page++ )
+      {
+        int16_t shift = ry - page * 8;
+
+        if( shift > -8 && shift < 8 )
+        {
+          _buf[ page * OLED_PX_HOR + x ] |=
+                             shift >= 0 ? glyph << shift : glyph >> -shift;
+        }
+      }
+    }
+  }
+}
+
+
+
+/*------------------------------- OLED_Strip::_column() ---------------------
+ *
+ * set or clear strip rows ry0 to ry1 - 1 of column x, a page byte at a time
+*/
+
+void OLED_Strip::_column( int16_t x, int16_t ry0, int16_t ry1, bool on )
+{
+  ry0 = ry0 < 0    ? 0    : ry0;
+  ry1 = ry1 > ROWS ? ROWS : ry1;
+
+  for( ; ry0 < ry1; ry0 = ( ry0 | 7 ) + 1 )   /* to the next page */
+  {
+    uint8_t first = ry0 & 7;
+    uint8_t last  = ( ry1 - 1 ) >> 3 == ry0 >> 3 ? ( ry1 - 1 ) & 7 : 7;
+    uint8_t bits  = ( 0xFF << first ) & ( 0xFF >> ( 7 - last ) );
+
+    uint8_t & byt = _buf[ ( ry0 >> 3 ) * OLED_PX_HOR + x ];
+
+    byt = on ? byt | bits : byt & ~bits;
+  }
+}
+
+
+/*----------------------------- eof oled_Strip.cpp --------------------------*/
@@ -0,0 +1,106 @@
+/* file oled_Strip.h
+*---------------------------------------------------------------------------
+*
+* graphics without a frame buffer, for the oled_I2C library.
+*
+* The screen is drawn a strip at a time. A strip is OLED_STRIP_PAGES pages
+* of 8 pixel rows, 128 bytes each. draw() clears the strip, calls the
+* application draw function to draw the whole screen into it, then sends
+* it in one I2C transaction, for each strip down the screen. Drawing is
+* clipped to the strip, so the draw function does not need to know.
+*
+* RAM is 128 bytes x OLED_STRIP_PAGES, against 1 KB for a 128x64 frame
+* buffer. The cost is running the draw function once per strip.
+*
+* Redraw of 128x64, bytes with the address byte (extras/host/strip_test),
+* not timed:
+*   frame buffer, one transaction     1034 bytes, ~93ms 100kHz, ~23ms 400kHz
+*   1 page strips, 8 transactions     1104 bytes, ~99ms 100kHz, ~25ms 400kHz
+*   plus the draw function 8 times. A few lines and text is ~1ms each
+*   at 16MHz, so the bus still takes most of the time.
+*
+* Coordinates are pixels, 0,0 top left, in landscape RAM order. Rotation
+* by the controller remap (ROTATE_180, mirrors) works, portrait does not.
+*
+*         © Dave Harris, 2021 (Andover, UK) MERG M2740
+*
+*-------------------------------Example usage---------------------------------
+*
+* OLED_I2C   oled;
+* OLED_Strip strip( oled );
+*
+* void gauge( OLED_Strip & s )
+* {
+*   s.rect( 0, 0, 128, 64 );
+*   s.line( 64, 60, 64 + dx, 60 - dy );
+*   s.textPROG( 40, 20, PSTR("PSI") );
+* }
+*
+* loop():   strip.draw( gauge );
+*
+*------------------------------------------------------------------------------
+*/
+#ifndef _oled_Strip_H_
+#define _oled_Strip_H_
+
+
+#include "oled_I2C.h"
+
+
+#define OLED_STRIP_PAGES  1           /* pages per strip: 1, 2, 4 or 8.     */
+                                      /*   Edit here, not in a sketch: the  */
+                                      /*   sketch and library must agree    */
+
+#if ( OLED_PX_VERT / 8 ) % OLED_STRIP_PAGES != 0
+  #error OLED_STRIP_PAGES must divide the display pages
+#endif
+
+
+
+class OLED_Strip;
+
+typedef void ( * OLED_DrawFn )( OLED_Strip & strip );   /* draws screen    */
+
+
+
+class OLED_Strip
+{
+  public:
+
+    OLED_Strip( OLED_I2C & oled ) : _oled( oled ) {}
+
+    void draw( OLED_DrawFn drawFn );  /* draw whole screen, strip by strip  */
+
+                              /* primitives, clipped to the current strip   */
+
+    void pixel( int16_t x, int16_t y, bool on = true );
+    void hline( int16_t x, int16_t y, int16_t w, bool on = true );
+    void vline( int16_t x, int16_t y, int16_t h, bool on = true );
+    void line( int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool on = true );
+    void rect( int16_t x, int16_t y, int16_t w, int16_t h, bool on = true );
+    void fillRect( int16_t x, int16_t y, int16_t w, int16_t h, bool on = true );
+
+                              /* text at any pixel x, y. chars 6 px wide    */
+
+    void text( int16_t x, int16_t y, const char * ram_str );
+    void textPROG( int16_t x, int16_t y, const char * prog_str );
+
+    int16_t top()    { return _y0; }                      /* strip rows     */
+    int16_t bottom() { return _y0 + OLED_STRIP_PAGES * 8; }
+
+
+  private:
+
+    OLED_I2C & _oled;
+
+    void _text( int16_t x, int16_t y, const char * str, bool prog );
+
+    void _column( int16_t x, int16_t ry0, int16_t ry1, bool on ); /* rows  */
+
+    uint8_t _buf[ OLED_STRIP_PAGES * OLED_PX_HOR ];
+    int16_t _y0;                      /* first pixel row of the strip       */
+
+}; /* end of class OLED_Strip */
+
+
+#endif /* _oled_Strip_H_ */
@@ -0,0 +1,246 @@
+/* file: soft_i2c.c
+ *
+ *  software (bit-banged) i2c library, write only. See soft_i2c.h
+ *
+ *  Dave Harris 2021
+*/
+
+#include "soft_i2c.h"
+#include "i2c.h"                                  /* shared I2C_ErrorFlag   */
+
+
+#if SI2C_HALF < 8
+#error "F_SI2C too high for F_CPU !"
+#endif
+
+
+uint8_t SI2C_NAckMask; /* set lane bits on NACK. Caller must clear */
+
+
+static uint8_t sda;    /* selected SDA lanes */
+
+
+#define SCL_MASK    ( 1 << SI2C_SCL )
+
+#define SCL_HIGH()  ( SI2C_DDR &= ~SCL_MASK )     /* release, pulled up     */
+#define SCL_LOW()   ( SI2C_DDR |= SCL_MASK )      /* drive low              */
+
+#define SI2C_WAIT() __builtin_avr_delay_cycles( SI2C_HALF - 5 )
+
+
+/* one bit on all lanes. low has the lanes to pull low, i.e. the 0 bits.
+ *  SDA is changed while SCL is low, then SCL is clocked high and low again  */
+
+#define SI2C_BIT( low )                                 \
+  SI2C_DDR = ( SI2C_DDR & ~sda ) | ( low );             \
+  SI2C_WAIT();                                          \
+  SCL_HIGH();                                           \
+  SI2C_WAIT();                                          \
+  SCL_LOW()
+
+
+
+/*----------------------------------------------------------------------------
+ Private Function: si2c_ack
+
+ Purpose: clock the ACK bit and note the lanes that did not ACK
+
+ Input Parameter: none
+
+ Return Value: none
+-----------------------------------------------------------------
+*/
+
+static void si2c_ack()
+{
+  SI2C_DDR &= ~sda;                               /* release SDA lanes      */
+  SI2C_WAIT();
+  SCL_HIGH();
+  SI2C_WAIT();
+  uint8_t nack = SI2C_PIN & sda;                  /* high lane = NACK       */
+  SCL_LOW();
+
+  if( nack )
+  {
+    SI2C_NAckMask |= nack;
+    I2C_ErrorFlag = 1;
+  }
+}
+
+
+
+/*----------------------------------------------------------------------------
+ Public Function: si2c_init
+
+ Purpose: Initialise soft I2C pins, bus idle. sdaMask is the default:
+          lanes already chosen with si2c_lanes() are kept, so
+          OLED_I2C::lanes() then init() sets up every selected display
+
+ Input Parameter:
+ - uint8_t sdaMask: SDA lanes, bits of SI2C_PORT, if none chosen yet
+
+ Return Value: none
+-----------------------------------------------------------------
+*/
+
+void si2c_init( uint8_t sdaMask )
+{
+  if( ! sda )                                     /* no lanes chosen yet    */
+  {
+    sda = sdaMask & ~SCL_MASK;
+  }
+
+  SI2C_PORT &= ~( sda | SCL_MASK );               /* open-drain: PORT = 0   */
+  SI2C_DDR  &= ~( sda | SCL_MASK );               /* released, bus idle     */
+}
+
+
+
+/*----------------------------------------------------------------------------
+ Public Function: si2c_lanes
+
+ Purpose: select SDA lanes for following transfers. Call with bus idle.
+
+ Input Parameter:
+ - uint8_t sdaMask: SDA lanes, bits of SI2C_PORT
+
+ Return Value: none
+-----------------------------------------------------------------
+*/
+
+void si2c_lanes( uint8_t sdaMask )
+{
+  sda = 0;                                        /* replace, not keep      */
+
+  si2c_init( sdaMask );
+}
+
+
+
+/*----------------------------------------------------------------------------
+ Public Function: si2c_start
+
+ Purpose: send start condition and address on all selected lanes
+
+ Input Parameter:
+ - uint8_t i2c_addr: Adress of reciever
+
+ Return Value: none
+-----------------------------------------------------------------
+*/
+
+void si2c_start( uint8_t i2c_addr )
+{
+  SI2C_DDR &= ~sda;                               /* SDA high               */
+  SCL_HIGH();
+  SI2C_WAIT();
+  SI2C_DDR |= sda;                                /* SDA low, SCL high      */
+  SI2C_WAIT();
+  SCL_LOW();
+
+  si2c_byte( i2c_addr );
+}
+
+
+
+/*----------------------------------------------------------------------------
+ Public Function: si2c_stop
+
+ Purpose: send stop condition on all selected lanes
+
+ Input Parameter: none
+
+ Return Value: none
+-----------------------------------------------------------------
+*/
+
+void si2c_stop()
+{
+  SI2C_DDR |= sda;                                /* SDA low                */
+  SI2C_WAIT();
+  SCL_HIGH();
+  SI2C_WAIT();
+  SI2C_DDR &= ~sda;                               /* SDA high, SCL high     */
+  SI2C_WAIT();
+}
+
+
+
+/*----------------------------------------------------------------------------
+ Public Function: si2c_byte
+
+ Purpose: send the same byte on all selected lanes, MSB first
+
+ Input Parameter:
+ - uint8_t byt: Byte to send to recievers
+
+ Return Value: none
+-----------------------------------------------------------------
+*/
+
+void si2c_byte( uint8_t byt )
+{
+  uint8_t low = sda;
+
+  SI2C_BIT( byt & 0x80 ? 0 : low );
+  SI2C_BIT( byt & 0x40 ? 0 : low );
+  SI2C_BIT( byt & 0x20 ? 0 : low );
+  SI2C_BIT( byt & 0x10 ? 0 : low );
+  SI2C_BIT( byt & 0x08 ? 0 : low );
+  SI2C_BIT( byt & 0x04 ? 0 : low );
+  SI2C_BIT( byt & 0x02 ? 0 : low );
+  SI2C_BIT( byt & 0x01 ? 0 : low );
+
+  si2c_ack();
+}
+
+
+
+/*----------------------------------------------------------------------------
+ Public Function: si2c_byteLanes
+
+ Purpose: send a different byte on each selected lane, MSB first.
+          The lane bytes are first spread into 8 masks, one per bit,
+          so the clocking runs at the same speed as si2c_byte()
+
+ Input Parameter:
+ - const uint8_t byts[8]: byts[n] is sent on the lane on port bit n.
+                          Bytes of lanes not selected are ignored.
+
+ Return Value: none
+-----------------------------------------------------------------
+*/
+
+void si2c_byteLanes( const uint8_t byts[] )
+{
+  uint8_t low[8] = { 0 };                         /* lanes low, per bit     */
+
+  for( uint8_t lane = 0; lane < 8; lane++ )
+  {
+    uint8_t inv  = ~byts[lane];                   /* 0 bits pull low        */
+    uint8_t lBit = 1 << lane;
+
+    if( inv & 0x80 ) low[0] |= lBit;
+    if( inv & 0x40 ) low[1] |= lBit;
+    if( inv & 0x20 ) low[2] |= lBit;
+    if( inv & 0x10 ) low[3] |= lBit;
+    if( inv & 0x08 ) low[4] |= lBit;
+    if( inv & 0x04 ) low[5] |= lBit;
+    if( inv & 0x02 ) low[6] |= lBit;
+    if( inv & 0x01 ) low[7] |= lBit;
+  }
+
+  SI2C_BIT( low[0] & sda );
+  SI2C_BIT( low[1] & sda );
+  SI2C_BIT( low[2] & sda );
+  SI2C_BIT( low[3] & sda );
+  SI2C_BIT( low[4] & sda );
+  SI2C_BIT( low[5] & sda );
+  SI2C_BIT( low[6] & sda );
+  SI2C_BIT( low[7] & sda );
+
+  si2c_ack();
+}
+
+
+/*-------------------- eof soft_i2c.c --------------------------------*/
@@ -0,0 +1,60 @@
+/* file: soft_i2c.h
+ *
+ *  software (bit-banged) i2c library, write only
+ *
+ *  SCL and SDA can be any pins of one port. SDA can be several pins of that
+ *  port at once, called lanes, all clocked by the one shared SCL pin. Each
+ *  lane is a separate bus, so up to 7 displays with the same address can be
+ *  written in parallel, in a single pass.
+ *
+ *  Pins are open-drain: driven low by setting the DDR bit, released high by
+ *  clearing it. PORT bits stay 0. SCL and every SDA lane need a pull-up.
+ *
+ *  Throughput at F_CPU 16MHz, worked from instruction counts:
+ *    hardware TWI, F_I2C 100kHz  ~ 11 kbyte/s,  1 bus
+ *    hardware TWI, F_I2C 400kHz  ~ 44 kbyte/s,  1 bus
+ *    si2c, F_SI2C 100kHz         ~ 11 kbyte/s per lane, x lanes
+ *    si2c, F_SI2C 400kHz         ~ 40 kbyte/s per lane, x lanes
+ *  si2c_byteLanes() adds ~200 cycles per byte to spread the lane bytes.
+ *
+ *  Dave Harris 2021
+*/
+
+#ifndef _soft_i2c_h_
+#define _soft_i2c_h_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define F_SI2C      100000UL  // clock soft I2C, max 400kHz for SSD1306
+
+#define SI2C_PORT   PORTD     // port of SCL and all SDA lanes
+#define SI2C_DDR    DDRD
+#define SI2C_PIN    PIND
+#define SI2C_SCL    2         // SCL bit in port   (PD2 = Nano D2)
+#define SI2C_SDA    ( 1 << 3 ) // default SDA lane  (PD3 = Nano D3)
+
+#define SI2C_HALF   ( F_CPU / F_SI2C / 2UL )  // cpu cycles per half SCL
+
+#include <stdio.h>
+#include <avr/io.h>
+
+
+extern uint8_t SI2C_NAckMask;  /* lanes that did not ACK. Caller must clear */
+
+
+void si2c_init( uint8_t sdaMask );          // init pins, default SDA lanes
+void si2c_lanes( uint8_t sdaMask );         // select SDA lanes
+void si2c_start( uint8_t i2c_addr );        // send start & adr on all lanes
+void si2c_stop();                           // send stop on all lanes
+void si2c_byte( uint8_t byt );              // send same byte on all lanes
+void si2c_byteLanes( const uint8_t byts[] ); // byts[bit#] on each SDA lane
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _soft_i2c_h_ */